@@ -1,5 +1,6 @@
 #include "FileData.h"
 
+#include "resources/TextureData.h"
 #include "utils/FileSystemUtil.h"
 #include "utils/StringUtil.h"
 #include "utils/TimeUtil.h"
@@ -56,7 +57,10 @@ FileData::~FileData()
 		mParent->removeChild(this);
 
 	if(mType == GAME)
-		mSystem->removeFromIndex(this);	
+	{
+		mSystem->removeFromIndex(this);
+		mSystem->removeFromCatalogue(this);
+	}
 }
 
 std::string FileData::getDisplayName() const
@@ -73,6 +77,9 @@ std::string FileData::getCleanName() const
 	return Utils::String::removeParenthesis(this->getDisplayName());
 }
 
+// Checked for every media lookup, resolved once
+static const bool* localArtSetting() { static const bool* slot = Settings::getInstance()->getBoolSlot("LocalArt"); return slot; }
+
 const std::string FileData::getThumbnailPath()
 {
 	std::string thumbnail = getMetadata().get("thumbnail");
@@ -83,7 +90,7 @@ const std::string FileData::getThumbnailPath()
 		thumbnail = getMetadata().get("image");
 		
 		// no image, try to use local image
-		if(thumbnail.empty() && Settings::getInstance()->getBool("LocalArt"))
+		if(thumbnail.empty() && *localArtSetting())
 		{
 			const char* extList[2] = { ".png", ".jpg" };
 			for(int i = 0; i < 2; i++)
@@ -104,7 +111,7 @@ const std::string FileData::getThumbnailPath()
 			thumbnail = getMetadata().get("image");
 
 		// no image, try to use local image
-		if (thumbnail.empty() && Settings::getInstance()->getBool("LocalArt"))
+		if (thumbnail.empty() && *localArtSetting())
 		{
 			const char* extList[2] = { ".png", ".jpg" };
 			for (int i = 0; i < 2; i++)
@@ -140,7 +147,7 @@ const bool FileData::getKidGame()
 	return getMetadata().get("kidgame") != "false";
 }
 
-static std::shared_ptr<bool> showFilenames;
+static const bool* showFilenames = nullptr;
 
 void FileData::resetSettings()
 {
@@ -149,10 +156,10 @@ void FileData::resetSettings()
 
 const std::string FileData::getName()
 {
+	// Faster than accessing map each time, and follows the setting changes
 	if (showFilenames == nullptr)
-		showFilenames = std::make_shared<bool>(Settings::getInstance()->getBool("ShowFilenames"));
+		showFilenames = Settings::getInstance()->getBoolSlot("ShowFilenames");
 
-	// Faster than accessing map each time
 	if (*showFilenames)
 	{
 		if (mSystem != nullptr && !mSystem->hasPlatformId(PlatformIds::ARCADE) && !mSystem->hasPlatformId(PlatformIds::NEOGEO))
@@ -179,7 +186,7 @@ const std::string FileData::getVideoPath()
 	std::string video = getMetadata().get("video");
 	
 	// no video, try to use local video
-	if(video.empty() && Settings::getInstance()->getBool("LocalArt"))
+	if(video.empty() && *localArtSetting())
 	{
 		std::string path = getSystemEnvData()->mStartPath + "/images/" + getDisplayName() + "-video.mp4";
 		if (Utils::FileSystem::exists(path))
@@ -197,7 +204,7 @@ const std::string FileData::getMarqueePath()
 	std::string marquee = getMetadata().get("marquee");
 
 	// no marquee, try to use local marquee
-	if (marquee.empty() && Settings::getInstance()->getBool("LocalArt"))
+	if (marquee.empty() && *localArtSetting())
 	{
 		const char* extList[2] = { ".png", ".jpg" };
 		for(int i = 0; i < 2; i++)
@@ -270,9 +277,7 @@ void FileData::launchGame(Window* window)
 	VolumeControl::getInstance()->deinit();
 
 	bool hideWindow = Settings::getInstance()->getBool("HideWindow");
-	window->deinit(hideWindow);
-
-	std::string command = getSystemEnvData()->mLaunchCommand;
+	window->deinit(hideWindow, TextureData::RESUMECACHE);
 
 	const std::string rom = Utils::FileSystem::getEscapedPath(getPath());
 	const std::string basename = Utils::FileSystem::getStem(getPath());
@@ -286,20 +291,8 @@ void FileData::launchGame(Window* window)
 	if (core.length() == 0)
 		core = getSystemEnvData()->getDefaultCore(emulator);
 
-	std::string customCommandLine = getSystemEnvData()->getEmulatorCommandLine(emulator);
-	if (customCommandLine.length() > 0)
-		command = customCommandLine;
-	
-
-
-	command = Utils::String::replace(command, "%EMULATOR%", emulator);
-	command = Utils::String::replace(command, "%CORE%", core);
-
-	command = Utils::String::replace(command, "%ROM%", rom);
-	command = Utils::String::replace(command, "%BASENAME%", basename);
-	command = Utils::String::replace(command, "%ROM_RAW%", rom_raw);		
-	command = Utils::String::replace(command, "%SYSTEM%", getSystemName());
-	command = Utils::String::replace(command, "%HOME%", Utils::FileSystem::getHomePath());
+	const std::string values[LaunchCommandTemplate::VARIABLE_COUNT] = { emulator, core, rom, basename, rom_raw, getSystemName(), Utils::FileSystem::getHomePath() };
+	std::string command = getSystemEnvData()->getLaunchCommand(emulator).expand(values);
 
 	Scripting::fireEvent("game-start", rom, basename);
 
@@ -0,0 +1,178 @@
+#include "MediaCatalogue.h"
+
+#include "utils/FileSystemUtil.h"
+#include "FileData.h"
+#include "FileFilterIndex.h"
+#include "SystemData.h"
+#include <stdlib.h>
+
+#define MAX_PICK_RETRIES 10
+
+MediaCatalogue::MediaCatalogue(SystemData* system, bool displayedOnly) : mSystem(system), mDisplayedOnly(displayedOnly)
+{
+	for (int type = 0; type < MEDIA_TYPE_COUNT; type++)
+		mBuilt[type] = false;
+}
+
+std::string MediaCatalogue::getMediaPath(FileData* game, MediaType type)
+{
+	switch (type)
+	{
+	case MEDIA_IMAGE:		return game->getImagePath();
+	case MEDIA_THUMBNAIL:	return game->getThumbnailPath();
+	case MEDIA_MARQUEE:		return game->getMarqueePath();
+	case MEDIA_VIDEO:		return game->getVideoPath();
+	default:				return "";
+	}
+}
+
+void MediaCatalogue::buildCatalogue(MediaType type)
+{
+	mBuilt[type] = true;
+
+	for (auto game : mSystem->getRootFolder()->getFilesRecursive(GAME, mDisplayedOnly))
+		addToCatalogue(game, type);
+}
+
+void MediaCatalogue::resetCatalogue()
+{
+	for (int type = 0; type < MEDIA_TYPE_COUNT; type++)
+	{
+		mGames[type].clear();
+		mPositions[type].clear();
+		mBuilt[type] = false;
+	}
+}
+
+void MediaCatalogue::addToCatalogue(FileData* game)
+{
+	for (int type = 0; type < MEDIA_TYPE_COUNT; type++)
+		if (mBuilt[type])
+			addToCatalogue(game, (MediaType)type);
+}
+
+void MediaCatalogue::addToCatalogue(FileData* game, MediaType type)
+{
+	if (game->getType() != GAME)
+		return;
+
+	if (mDisplayedOnly)
+	{
+		FileFilterIndex* idx = mSystem->getIndex(false);
+		if (idx != nullptr && idx->isFiltered() && !idx->showFile(game))
+			return;
+	}
+
+	if (mPositions[type].find(game) != mPositions[type].cend())
+		return;
+
+	if (getMediaPath(game, type).empty())
+		return;
+
+	mPositions[type][game] = mGames[type].size();
+	mGames[type].push_back(game);
+}
+
+void MediaCatalogue::removeAt(MediaType type, size_t index)
+{
+	// Swap with the last entry so the array stays dense
+	FileData* game = mGames[type][index];
+	FileData* last = mGames[type].back();
+
+	mGames[type][index] = last;
+	mPositions[type][last] = index;
+
+	mGames[type].pop_back();
+	mPositions[type].erase(game);
+}
+
+void MediaCatalogue::removeFromCatalogue(FileData* game)
+{
+	for (int type = 0; type < MEDIA_TYPE_COUNT; type++)
+	{
+		auto it = mPositions[type].find(game);
+		if (it != mPositions[type].cend())
+			removeAt((MediaType)type, it->second);
+	}
+}
+
+void MediaCatalogue::updateCatalogue(FileData* game)
+{
+	removeFromCatalogue(game);
+	addToCatalogue(game);
+}
+
+size_t MediaCatalogue::getCount(MediaType type)
+{
+	if (!mBuilt[type])
+		buildCatalogue(type);
+
+	return mGames[type].size();
+}
+
+FileData* MediaCatalogue::pickRandom(MediaType type, std::string& path)
+{
+	for (int retry = 0; retry < MAX_PICK_RETRIES; retry++)
+	{
+		size_t count = getCount(type);
+		if (count == 0)
+			break;
+
+		size_t index = (size_t)rand() % count;
+		FileData* game = mGames[type][index];
+
+		path = getMediaPath(game, type);
+		if (!path.empty() && Utils::FileSystem::exists(path))
+			return game;
+
+		// Media was removed since the catalogue was built
+		removeAt(type, index);
+	}
+
+	path = "";
+	return nullptr;
+}
+
+FileData* MediaCatalogue::pickRandomGame(MediaType type, std::string& path)
+{
+	for (int retry = 0; retry < MAX_PICK_RETRIES; retry++)
+	{
+		size_t total = 0;
+		for (auto system : SystemData::sSystemVector)
+			if (system->isGameSystem() && !system->isCollection())
+				total += system->getMediaCatalogue()->getCount(type);
+
+		if (total == 0)
+			break;
+
+		// Pick uniformly among all games, then find the system owning that position
+		size_t index = (size_t)rand() % total;
+
+		for (auto system : SystemData::sSystemVector)
+		{
+			if (!system->isGameSystem() || system->isCollection())
+				continue;
+
+			MediaCatalogue* catalogue = system->getMediaCatalogue();
+
+			size_t count = catalogue->getCount(type);
+			if (index >= count)
+			{
+				index -= count;
+				continue;
+			}
+
+			FileData* game = catalogue->mGames[type][index];
+
+			path = getMediaPath(game, type);
+			if (!path.empty() && Utils::FileSystem::exists(path))
+				return game;
+
+			catalogue->removeAt(type, index);
+			break;
+		}
+	}
+
+	path = "";
+	return nullptr;
+}
@@ -0,0 +1,59 @@
+#pragma once
+#ifndef ES_APP_MEDIA_CATALOGUE_H
+#define ES_APP_MEDIA_CATALOGUE_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class FileData;
+class SystemData;
+
+enum MediaType
+{
+	MEDIA_IMAGE,
+	MEDIA_THUMBNAIL,
+	MEDIA_MARQUEE,
+	MEDIA_VIDEO,
+
+	MEDIA_TYPE_COUNT
+};
+
+// Games of a system that have media, one dense array per media type.
+// Each media type is built on its first use, as resolving a media path can hit the disk. Then it's maintained when games are added, changed or deleted. A catalogue of the displayed games only
+// follows the filters active when it was built : it is reset when they change.
+// Entries whose media disappeared from disk are dropped lazily, when they are picked.
+class MediaCatalogue
+{
+public:
+	MediaCatalogue(SystemData* system, bool displayedOnly);
+
+	void addToCatalogue(FileData* game);
+	void removeFromCatalogue(FileData* game);
+	void updateCatalogue(FileData* game);
+	void resetCatalogue();
+
+	size_t getCount(MediaType type);
+
+	// Returns a random game having the media, and its path. nullptr if there is none
+	FileData* pickRandom(MediaType type, std::string& path);
+
+	// Same as above, across the catalogues of every game system (collections excluded)
+	static FileData* pickRandomGame(MediaType type, std::string& path);
+
+	static std::string getMediaPath(FileData* game, MediaType type);
+
+private:
+	void buildCatalogue(MediaType type);
+	void addToCatalogue(FileData* game, MediaType type);
+	void removeAt(MediaType type, size_t index);
+
+	SystemData* mSystem;
+	bool		mDisplayedOnly;
+	bool		mBuilt[MEDIA_TYPE_COUNT];
+
+	std::vector<FileData*>						mGames[MEDIA_TYPE_COUNT];
+	std::unordered_map<FileData*, size_t>		mPositions[MEDIA_TYPE_COUNT];
+};
+
+#endif // ES_APP_MEDIA_CATALOGUE_H
@@ -146,14 +146,13 @@ MetaDataList MetaDataList::createFromXML(MetaDataListType type, pugi::xml_node&
 		{			
 			std::string value = md.text().get();
 
-		//	if (iter->type == MD_PATH) // if it's a path, resolve relative paths
-		//		value = Utils::FileSystem::resolveRelativePath(value, relativeTo, true);
-
 			if (value == iter->defaultValue)
 				continue;
 			
 			if (iter->type == MD_BOOL)
 				value = Utils::String::toLower(value);
+			else if (iter->type == MD_PATH && system != nullptr) // if it's a path, resolve relative paths once, appendToXML makes them relative again
+				value = Utils::FileSystem::resolveRelativePath(value, system->getStartPath(), true);
 
 			if (iter->id == 0)
 				mdl.mName = value;
@@ -212,12 +211,19 @@ void MetaDataList::set(const std::string& key, const std::string& value)
 	else
 	{
 		auto id = getId(key);
+
+		// paths are stored resolved, appendToXML makes them relative again
+		std::string resolved;
+		if (getType(id) == MD_PATH && mRelativeTo != nullptr && !value.empty())
+			resolved = Utils::FileSystem::resolveRelativePath(value, mRelativeTo->getStartPath(), true);
+
+		const std::string& newValue = resolved.empty() ? value : resolved;
 		
 		auto prev = mMap.find(id);
-		if (prev != mMap.cend() && prev->second == value)
+		if (prev != mMap.cend() && prev->second == newValue)
 			return;
 
-		mMap[id] = value;
+		mMap[id] = newValue;
 	}
 
 	mWasChanged = true;
@@ -232,12 +238,7 @@ const std::string MetaDataList::get(const std::string& key) const
 
 	auto it = mMap.find(id);
 	if (it != mMap.end())
-	{		
-		if (getType(id) == MD_PATH && mRelativeTo != nullptr) // if it's a path, resolve relative paths				
-			return Utils::FileSystem::resolveRelativePath(it->second, mRelativeTo->getStartPath(), true);
-
-		return it->second;
-	}
+		return it->second; // paths are already resolved by createFromXML and set
 
 	if (mType == GAME_METADATA)
 		return mDefaultGameMap.at(id);
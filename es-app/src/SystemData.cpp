@@ -8,9 +8,11 @@
 #include "Log.h"
 #include "platform.h"
 #include "Settings.h"
+#include "StartupTrace.h"
 #include "ThemeData.h"
 #include "views/UIModeController.h"
 #include <fstream>
+#include <string.h>
 #include "utils/StringUtil.h"
 #include "utils/ThreadPool.h"
 #include "GuiComponent.h"
@@ -21,6 +23,69 @@ using namespace Utils;
 
 std::vector<SystemData*> SystemData::sSystemVector;
 
+static const char* sLaunchVariables[LaunchCommandTemplate::VARIABLE_COUNT] = { "%EMULATOR%", "%CORE%", "%ROM%", "%BASENAME%", "%ROM_RAW%", "%SYSTEM%", "%HOME%" };
+
+LaunchCommandTemplate::LaunchCommandTemplate(const std::string& command) : mLiteralLength(0)
+{
+	std::string literal;
+
+	for (size_t i = 0; i < command.size(); )
+	{
+		int variable = -1;
+
+		if (command[i] == '%')
+		{
+			for (int v = 0; v < VARIABLE_COUNT; v++)
+			{
+				if (command.compare(i, strlen(sLaunchVariables[v]), sLaunchVariables[v]) == 0)
+				{
+					variable = v;
+					break;
+				}
+			}
+		}
+
+		// anything else, like environment variables on Windows, is kept as is
+		if (variable < 0)
+		{
+			literal += command[i++];
+			continue;
+		}
+
+		if (!literal.empty())
+		{
+			mSegments.push_back({ -1, literal });
+			mLiteralLength += literal.size();
+			literal.clear();
+		}
+
+		mSegments.push_back({ variable, "" });
+		i += strlen(sLaunchVariables[variable]);
+	}
+
+	if (!literal.empty())
+	{
+		mSegments.push_back({ -1, literal });
+		mLiteralLength += literal.size();
+	}
+}
+
+std::string LaunchCommandTemplate::expand(const std::string (&values)[VARIABLE_COUNT]) const
+{
+	size_t length = mLiteralLength;
+	for (auto& segment : mSegments)
+		if (segment.variable >= 0)
+			length += values[segment.variable].size();
+
+	std::string command;
+	command.reserve(length);
+
+	for (auto& segment : mSegments)
+		command += (segment.variable < 0 ? segment.text : values[segment.variable]);
+
+	return command;
+}
+
 SystemData::SystemData(const std::string& name, const std::string& fullName, SystemEnvironmentData* envData, const std::string& themeFolder, bool CollectionSystem) :
 	mName(name), mFullName(fullName), mEnvData(envData), mThemeFolder(themeFolder), mIsCollectionSystem(CollectionSystem), mIsGameSystem(true)
 {
@@ -31,6 +96,8 @@ SystemData::SystemData(const std::string& name, const std::string& fullName, Sys
 	mGridSizeOverride = Vector2f(0, 0);
 	mViewModeChanged = false;
 	mFilterIndex = nullptr;// new FileFilterIndex();
+	mMediaCatalogue = nullptr;
+	mAllMediaCatalogue = nullptr;
 
 	// if it's an actual system, initialize it, if not, just create the data structure
 	if (!CollectionSystem)
@@ -92,6 +159,19 @@ Vector2f SystemData::getGridSizeOverride()
 
 SystemData::~SystemData()
 {
+	// Delete the catalogues first, there's no need to maintain them while the games are deleted
+	if (mMediaCatalogue != nullptr)
+	{
+		delete mMediaCatalogue;
+		mMediaCatalogue = nullptr;
+	}
+
+	if (mAllMediaCatalogue != nullptr)
+	{
+		delete mAllMediaCatalogue;
+		mAllMediaCatalogue = nullptr;
+	}
+
 	delete mRootFolder;
 
 	if (mFilterIndex != nullptr)
@@ -206,6 +286,15 @@ FileFilterIndex* SystemData::getIndex(bool createIndex)
 	return mFilterIndex; 
 }
 
+MediaCatalogue* SystemData::getMediaCatalogue(bool displayedOnly)
+{
+	MediaCatalogue*& catalogue = displayedOnly ? mMediaCatalogue : mAllMediaCatalogue;
+	if (catalogue == nullptr)
+		catalogue = new MediaCatalogue(this, displayedOnly);
+
+	return catalogue;
+}
+
 void SystemData::indexAllGameFilters(const FolderData* folder)
 {
 	const std::vector<FileData*>& children = folder->getChildren();
@@ -347,6 +436,7 @@ SystemData* SystemData::loadSystem(pugi::xml_node system)
 	envData->mLaunchCommand = cmd;
 	envData->mPlatformIds = platformIds;
 	envData->mEmulators = emulatorList;
+	envData->compileLaunchCommands();
 
 	SystemData* newSys = new SystemData(name, fullname, envData, themeFolder);
 	if (newSys->getRootFolder()->getChildren().size() == 0)
@@ -433,6 +523,7 @@ bool SystemData::loadConfig(Window* window)
 		{
 			pThreadPool->queueWorkItem([system, currentSystem, systems, &processedSystem]
 			{				
+				StartupTrace::Phase phase(std::string("system ") + system.child("name").text().get());
 				systems[currentSystem] = loadSystem(system);
 				processedSystem++;
 			});
@@ -446,6 +537,7 @@ bool SystemData::loadConfig(Window* window)
 
 			std::string nm = system.child("name").text().get();
 			StopWatch watch("SystemData " + nm);
+			StartupTrace::Phase phase("system " + nm);
 
 			SystemData* pSystem = loadSystem(system);
 			if (pSystem != nullptr)
@@ -4,6 +4,7 @@
 
 #include "PlatformId.h"
 #include <algorithm>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -14,6 +15,7 @@
 #include <unordered_set>
 
 #include "FileFilterIndex.h"
+#include "MediaCatalogue.h"
 #include "Settings.h"
 
 class FileData;
@@ -28,6 +30,28 @@ struct EmulatorData
 	std::vector<std::string> mCores;
 };
 
+// A launch command split once into literal parts and %VARIABLES%, launching a game only concatenates the parts
+class LaunchCommandTemplate
+{
+public:
+	enum Variable { EMULATOR, CORE, ROM, BASENAME, ROM_RAW, SYSTEM, HOME, VARIABLE_COUNT };
+
+	LaunchCommandTemplate() : mLiteralLength(0) { }
+	LaunchCommandTemplate(const std::string& command);
+
+	std::string expand(const std::string (&values)[VARIABLE_COUNT]) const;
+
+private:
+	struct Segment
+	{
+		int variable; // Variable, or -1 for literal text
+		std::string text;
+	};
+
+	std::vector<Segment> mSegments;
+	size_t mLiteralLength;
+};
+
 struct SystemEnvironmentData
 {
 	std::string mSystemName;
@@ -96,6 +120,33 @@ struct SystemEnvironmentData
 
 		return "";
 	}
+
+	// Compiles the system command and the command lines of the emulators, done when the system is loaded
+	void compileLaunchCommands()
+	{
+		mLaunchCommands.clear();
+		mLaunchCommands[""] = LaunchCommandTemplate(mLaunchCommand);
+
+		for (auto& emulator : mEmulators)
+			if (!emulator.mCommandLine.empty())
+				mLaunchCommands.emplace(emulator.mName, LaunchCommandTemplate(emulator.mCommandLine));
+	}
+
+	// The command line of the emulator if it has one, otherwise the system command
+	const LaunchCommandTemplate& getLaunchCommand(const std::string& emulatorName)
+	{
+		if (mLaunchCommands.empty())
+			compileLaunchCommands();
+
+		auto it = mLaunchCommands.find(emulatorName);
+		if (it != mLaunchCommands.cend())
+			return it->second;
+
+		return mLaunchCommands[""];
+	}
+
+private:
+	std::map<std::string, LaunchCommandTemplate> mLaunchCommands; // by emulator name, "" for the system command
 };
 
 class SystemData
@@ -165,6 +216,7 @@ public:
 
 	void resetFilters() {
 		if (mFilterIndex != nullptr) mFilterIndex->resetFilters();
+		resetMediaCatalogue();
 	};
 
 	void resetIndex() {
@@ -173,10 +225,29 @@ public:
 	
 	void setUIModeFilters() {
 		if (mFilterIndex != nullptr) mFilterIndex->setUIModeFilters();
+		resetMediaCatalogue();
 	}
 
 	void deleteIndex();
 
+	// displayedOnly : games passing the gamelist filters (screensaver), otherwise all the games (random playlists)
+	MediaCatalogue* getMediaCatalogue(bool displayedOnly = true);
+
+	// The filtered catalogue is built again on next use, call it when the filters change
+	void resetMediaCatalogue() {
+		if (mMediaCatalogue != nullptr) mMediaCatalogue->resetCatalogue();
+	};
+
+	void removeFromCatalogue(FileData* game) {
+		if (mMediaCatalogue != nullptr) mMediaCatalogue->removeFromCatalogue(game);
+		if (mAllMediaCatalogue != nullptr) mAllMediaCatalogue->removeFromCatalogue(game);
+	};
+
+	void updateCatalogue(FileData* game) {
+		if (mMediaCatalogue != nullptr) mMediaCatalogue->updateCatalogue(game);
+		if (mAllMediaCatalogue != nullptr) mAllMediaCatalogue->updateCatalogue(game);
+	};
+
 	unsigned int getSortId() const { return mSortId; };
 	void setSortId(const unsigned int sortId = 0);
 
@@ -206,6 +277,8 @@ private:
 	void setIsGameSystemStatus();
 
 	FileFilterIndex* mFilterIndex;
+	MediaCatalogue* mMediaCatalogue;
+	MediaCatalogue* mAllMediaCatalogue;
 
 	FolderData* mRootFolder;
 	int			mGameCount;
@@ -9,6 +9,7 @@
 #include "views/ViewController.h"
 #include "FileData.h"
 #include "FileFilterIndex.h"
+#include "MediaCatalogue.h"
 #include "Log.h"
 #include "PowerSaver.h"
 #include "Sound.h"
@@ -26,10 +27,6 @@ SystemScreenSaver::SystemScreenSaver(Window* window) :
 	mVideoScreensaver(NULL),
 	mImageScreensaver(NULL),
 	mWindow(window),
-	mVideosCounted(false),
-	mVideoCount(0),
-	mImagesCounted(false),
-	mImageCount(0),
 	mState(STATE_INACTIVE),
 	mOpacity(0.0f),
 	mTimer(0),
@@ -91,17 +88,9 @@ void SystemScreenSaver::startScreenSaver()
 		else
 			mOpacity = 0.0f;
 			
-		// Load a random video
+		// Load a random video, the catalogue only returns existing files
 		std::string path = pickRandomVideo();
-
-		int retry = 10;
-		while (retry > 0 && !Utils::FileSystem::exists(path))
-		{
-			retry--;
-			path = pickRandomVideo();
-		}
-
-		if (!path.empty() && Utils::FileSystem::exists(path))
+		if (!path.empty())
 		{
 			LOG(LogDebug) << "VideoScreenSaver::startScreenSaver " << path.c_str();
 
@@ -240,123 +229,36 @@ void SystemScreenSaver::renderScreenSaver()
 	}
 }
 
-unsigned long SystemScreenSaver::countGameListNodes(const char *nodeName)
-{
-	unsigned long nodeCount = 0;
-	std::vector<SystemData*>::const_iterator it;
-	for (it = SystemData::sSystemVector.cbegin(); it != SystemData::sSystemVector.cend(); ++it)
-	{
-		// We only want nodes from game systems that are not collections
-		if (!(*it)->isGameSystem() || (*it)->isCollection())
-			continue;
-
-		FolderData* rootFileData = (*it)->getRootFolder();
-
-		std::vector<FileData*> allFiles = rootFileData->getFilesRecursive(GAME, true);
-		std::vector<FileData*>::const_iterator itf;  // declare an iterator to a vector of strings
-
-		for (itf=allFiles.cbegin() ; itf < allFiles.cend(); itf++) 
-		{
-			if ((strcmp(nodeName, "video") == 0 && (*itf)->getVideoPath() != "") ||
-				(strcmp(nodeName, "image") == 0 && (*itf)->getImagePath() != ""))
-			{
-				nodeCount++;
-			}
-		}
-	}
-	return nodeCount;
-}
-
-void SystemScreenSaver::countVideos()
+std::string SystemScreenSaver::pickRandomGameMedia(MediaType type)
 {
-	if (!mVideosCounted)
-	{
-		mVideoCount = countGameListNodes("video");
-		mVideosCounted = true;
-	}
-}
-
-void SystemScreenSaver::countImages()
-{
-	if (!mImagesCounted)
-	{
-		mImageCount = countGameListNodes("image");
-		mImagesCounted = true;
-	}
-}
+	mCurrentGame = NULL;
 
-std::string SystemScreenSaver::pickGameListNode(unsigned long index, const char *nodeName)
-{
 	std::string path;
+	FileData* game = MediaCatalogue::pickRandomGame(type, path);
+	if (game == nullptr)
+		return "";
 
-	std::vector<SystemData*>::const_iterator it;
-	for (it = SystemData::sSystemVector.cbegin(); it != SystemData::sSystemVector.cend(); ++it)
-	{
-		// We only want nodes from game systems that are not collections
-		if (!(*it)->isGameSystem() || (*it)->isCollection())
-			continue;
-
-		FolderData* rootFileData = (*it)->getRootFolder();
-
-		FileType type = GAME;
-		std::vector<FileData*> allFiles = rootFileData->getFilesRecursive(type, true);
-		std::vector<FileData*>::const_iterator itf;  // declare an iterator to a vector of strings
-
-		for(itf=allFiles.cbegin() ; itf < allFiles.cend(); itf++) 
-		{
-			if ((strcmp(nodeName, "video") == 0 && (*itf)->getVideoPath() != "") ||
-				(strcmp(nodeName, "image") == 0 && (*itf)->getImagePath() != ""))
-			{
-				if (index-- <= 0)
-				{
-					// We have it
-					if (strcmp(nodeName, "video") == 0)
-						path = (*itf)->getVideoPath();
-					else if (strcmp(nodeName, "image") == 0)
-						path = (*itf)->getImagePath();
-
-					if (!Utils::FileSystem::exists(path))
-						continue;
-
-					mSystemName = (*it)->getFullName();
-					mGameName = (*itf)->getName();
-					mCurrentGame = (*itf);
+	mSystemName = game->getSystem()->getFullName();
+	mGameName = game->getName();
+	mCurrentGame = game;
 
 #ifdef _RPI_
-					if (Settings::getInstance()->getBool("ScreenSaverOmxPlayer"))
-						if (Settings::getInstance()->getString("ScreenSaverGameInfo") != "never" && strcmp(nodeName, "video") == 0)
-							writeSubtitle(mGameName.c_str(), mSystemName.c_str(), (Settings::getInstance()->getString("ScreenSaverGameInfo") == "always"));
+	if (Settings::getInstance()->getBool("ScreenSaverOmxPlayer"))
+		if (Settings::getInstance()->getString("ScreenSaverGameInfo") != "never" && type == MEDIA_VIDEO)
+			writeSubtitle(mGameName.c_str(), mSystemName.c_str(), (Settings::getInstance()->getString("ScreenSaverGameInfo") == "always"));
 #endif
 
-					return path;
-				}
-			}
-		}
-	}
-
-	return "";
+	return path;
 }
 
 std::string SystemScreenSaver::pickRandomVideo()
 {
-	countVideos();
-	mCurrentGame = NULL;
-	if (mVideoCount == 0)
-		return "";
-	
-	int video = (int)(((float)rand() / float(RAND_MAX)) * (float)mVideoCount);
-	return pickGameListNode(video, "video");
+	return pickRandomGameMedia(MEDIA_VIDEO);
 }
 
 std::string SystemScreenSaver::pickRandomGameListImage()
 {
-	countImages();
-	mCurrentGame = NULL;
-	if (mImageCount == 0)
-		return "";
-	
-	int image = (int)(((float)rand() / float(RAND_MAX)) * (float)mImageCount);
-	return pickGameListNode(image, "image");
+	return pickRandomGameMedia(MEDIA_IMAGE);
 }
 
 std::string SystemScreenSaver::pickRandomCustomImage()
@@ -5,6 +5,7 @@
 #include "Window.h"
 #include "GuiComponent.h"
 #include "renderers/Renderer.h"
+#include "MediaCatalogue.h"
 
 class ImageComponent;
 class Sound;
@@ -82,14 +83,11 @@ public:
 
 	virtual FileData* getCurrentGame();
 	virtual void launchGame();
-	inline virtual void resetCounts() { mVideosCounted = false; mImagesCounted = false; };
+	// Media are picked from the systems' MediaCatalogue, kept up to date and reset when the gamelist filters change
+	inline virtual void resetCounts() { };
 
 private:
-	unsigned long countGameListNodes(const char *nodeName);
-	void countVideos();
-	void countImages();
-
-	std::string pickGameListNode(unsigned long index, const char *nodeName);
+	std::string pickRandomGameMedia(MediaType type);
 	std::string pickRandomVideo();
 	std::string pickRandomGameListImage();
 	std::string pickRandomCustomImage();
@@ -102,11 +100,6 @@ private:
 	};
 
 private:
-	bool			mVideosCounted;
-	unsigned long		mVideoCount;	
-	bool			mImagesCounted;
-	unsigned long		mImageCount;
-
 	//VideoComponent*		mVideoScreensaver;
 	std::shared_ptr<VideoScreenSaver>		mVideoScreensaver;
 
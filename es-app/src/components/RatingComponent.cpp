@@ -9,6 +9,7 @@ RatingComponent::RatingComponent(Window* window) : GuiComponent(window), mColorS
 	mUnfilledTexture = TextureResource::get(":/star_unfilled.svg", true);
 	mValue = 0.5f;
 	mSize = Vector2f(64 * NUM_RATING_STARS, 64);
+	mCullable = true;
 	updateVertices();
 	updateColors();
 }
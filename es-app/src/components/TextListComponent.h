@@ -42,6 +42,7 @@ public:
 	bool input(InputConfig* config, Input input) override;
 	void update(int deltaTime) override;
 	void render(const Transform4x4f& parentTrans) override;
+	bool isAnimating() override { return mMarqueeOffset != 0 || mMarqueeOffset2 != 0 || IList<TextListData, T>::isAnimating(); }
 	void applyTheme(const std::shared_ptr<ThemeData>& theme, const std::string& view, const std::string& element, unsigned int properties) override;
 
 	void add(const std::string& name, const T& obj, unsigned int colorId);
@@ -108,6 +109,10 @@ private:
 	unsigned int mColors[COLOR_ID_COUNT];
 
 	ImageComponent mSelectorImage;
+
+	// rows whose text caches were kept by the last render, the others don't hold any
+	int mCacheStart;
+	int mCacheEnd;
 };
 
 template <typename T>
@@ -132,6 +137,8 @@ TextListComponent<T>::TextListComponent(Window* window) :
 	mSelectedColor = 0;
 	mColors[0] = 0x0000FFFF;
 	mColors[1] = 0x00FF00FF;
+	mCacheStart = 0;
+	mCacheEnd = 0;
 }
 
 template <typename T>
@@ -257,6 +264,19 @@ void TextListComponent<T>::render(const Transform4x4f& parentTrans)
 		y += entrySize;
 	}
 
+	// only keep the text caches of the visible rows and of one page on each side, so memory doesn't grow with the list size.
+	// The rows kept by the last render are scanned with one more page on each side, for the rows shifted by a removal
+	int keepStart = startEntry - screenCount;
+	int keepEnd = listCutoff + screenCount;
+
+	int scanEnd = Math::min(mCacheEnd + screenCount, size());
+	for(int i = Math::max(mCacheStart - screenCount, 0); i < scanEnd; i++)
+		if(i < keepStart || i >= keepEnd)
+			mEntries.at((unsigned int)i).data.textCache.reset();
+
+	mCacheStart = keepStart;
+	mCacheEnd = keepEnd;
+
 	Renderer::popClipRect();
 
 	listRenderTitleOverlay(trans);
@@ -317,7 +337,9 @@ void TextListComponent<T>::update(int deltaTime)
 		mMarqueeOffset2 = 0;
 
 		// if we're not scrolling and this object's text goes outside our size, marquee it!
-		const float textLength = mFont->sizeText(mEntries.at((unsigned int)mCursor).name).x();
+		// use the metrics of the text cache when it's there, it's what is drawn
+		const auto& entry = mEntries.at((unsigned int)mCursor);
+		const float textLength = entry.data.textCache ? entry.data.textCache->metrics.size.x() : mFont->sizeText(entry.name).x();
 		const float limit      = mSize.x() - mHorizontalMargin * 2;
 
 		if(textLength > limit)
@@ -746,7 +746,6 @@ void GuiMenu::openUISettings()
 			PowerSaver::init();
 		}
 		Settings::getInstance()->setString("TransitionStyle", transition_style->getSelected());
-		GuiComponent::ALLOWANIMATIONS = Settings::getInstance()->getString("TransitionStyle") != "instant";
 	});
 	
 	auto transitionOfGames_style = std::make_shared< OptionListComponent<std::string> >(mWindow, _("GAME LAUNCH TRANSITION"), false);
@@ -1152,8 +1151,6 @@ void GuiMenu::openOtherSettings()
 			Settings::getInstance()->setBool("EnableSounds", false);
 		}
 
-		GuiComponent::ALLOWANIMATIONS = Settings::getInstance()->getString("TransitionStyle") != "instant";
-
 		Settings::getInstance()->setString("PowerSaverMode", power_saver->getSelected());
 		PowerSaver::init();
 	});
@@ -1223,6 +1220,12 @@ void GuiMenu::openOtherSettings()
 	s->addWithLabel(_("VRAM LIMIT"), max_vram);
 	s->addSaveFunc([max_vram] { Settings::getInstance()->setInt("MaxVRAM", (int)Math::round(max_vram->getValue())); });
 
+	// memory budget shared by textures, sounds and views, 0 = no limit
+	auto memory_budget = std::make_shared<SliderComponent>(mWindow, 0.f, 2000.f, 10.f, "Mb");
+	memory_budget->setValue((float)(Settings::getInstance()->getInt("MemoryBudget")));
+	s->addWithLabel(_("MEMORY LIMIT"), memory_budget);
+	s->addSaveFunc([memory_budget] { Settings::getInstance()->setInt("MemoryBudget", (int)Math::round(memory_budget->getValue())); });
+
 
 	/*
 #if WIN32
@@ -1311,7 +1314,6 @@ void GuiMenu::openOtherSettings()
 	s->addWithLabel(_("OPTIMIZE IMAGES VRAM USE"), optimizeVram);
 	s->addSaveFunc([optimizeVram]
 	{
-		TextureData::OPTIMIZEVRAM = optimizeVram->getState();
 		Settings::getInstance()->setBool("OptimizeVRAM", optimizeVram->getState());
 	});
 
@@ -1339,6 +1341,12 @@ void GuiMenu::openOtherSettings()
 	s->addWithLabel(_("THREADED LOADING"), threadedLoading);
 	s->addSaveFunc([threadedLoading] { Settings::getInstance()->setBool("ThreadedLoading", threadedLoading->getState()); });
 
+	// keep images in RAM, so returning from a game doesn't load them again
+	auto resumeCache = std::make_shared<SwitchComponent>(mWindow);
+	resumeCache->setState(Settings::getInstance()->getBool("ResumeCache"));
+	s->addWithLabel(_("FAST RESUME AFTER GAMES"), resumeCache);
+	s->addSaveFunc([resumeCache] { Settings::getInstance()->setBool("ResumeCache", resumeCache->getState()); });
+
 #ifndef _RPI_
 	// full exit
 	auto fullExitMenu = std::make_shared<SwitchComponent>(mWindow);
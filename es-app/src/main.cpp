@@ -8,18 +8,21 @@
 #include "CollectionSystemManager.h"
 #include "EmulationStation.h"
 #include "InputManager.h"
+#include "InputScript.h"
 #include "Log.h"
 #include "MameNames.h"
 #include "platform.h"
 #include "PowerSaver.h"
 #include "ScraperCmdLine.h"
 #include "Settings.h"
+#include "StartupTrace.h"
 #include "SystemData.h"
 #include "SystemScreenSaver.h"
 #include <SDL_events.h>
 #include <SDL_main.h>
 #include <SDL_timer.h>
 #include <iostream>
+#include <thread>
 #include <time.h>
 
 #if defined(_WIN32)
@@ -28,6 +31,7 @@
 #include <unistd.h>
 #endif
 
+#include "resources/ResourceManager.h"
 #include "resources/TextureData.h"
 #include <FreeImage.h>
 #include "AudioManager.h"
@@ -40,6 +44,7 @@ bool scrape_cmdline = false;
 
 static std::string gPlayVideo;
 static int gPlayVideoDuration = 0;
+static std::string gInputScript;
 
 void playVideo()
 {
@@ -298,6 +303,36 @@ bool parseArgs(int argc, char* argv[])
 		{
 			Settings::getInstance()->setBool("ForceKid", true);
 		}
+		else if (strcmp(argv[i], "--input-script") == 0)
+		{
+			if (i >= argc - 1)
+			{
+				std::cerr << "Invalid input script supplied.";
+				return false;
+			}
+
+			gInputScript = argv[i + 1];
+			i++; // skip the argument value
+		}
+		else if (strcmp(argv[i], "--pack-resources") == 0)
+		{
+			if (i >= argc - 1)
+			{
+				std::cerr << "Invalid resource archive supplied.";
+				return false;
+			}
+
+			std::string directory = Utils::FileSystem::getExePath() + "/resources";
+			if (!Utils::FileSystem::isDirectory(directory))
+				directory = Utils::FileSystem::getCWDPath() + "/resources";
+
+			if (ResourceManager::packResources(directory, argv[i + 1]))
+				std::cout << "Resources packed into " << argv[i + 1] << "\n";
+			else
+				std::cerr << "Unable to pack " << directory << " into " << argv[i + 1] << "\n";
+
+			return false; // exit after packing
+		}
 		else if (strcmp(argv[i], "--force-disable-filters") == 0)
 		{
 			Settings::getInstance()->setBool("ForceDisableFilters", true);
@@ -331,6 +366,8 @@ bool parseArgs(int argc, char* argv[])
 				"--force-kid		Force the UI mode to be Kid\n"
 				"--force-kiosk		Force the UI mode to be Kiosk\n"
 				"--force-disable-filters		Force the UI to ignore applied filters in gamelist\n"
+				"--input-script [path]		play a scripted input sequence and exit, for benchmarks\n"
+				"--pack-resources [path]		pack the bundled resources into a single archive and exit\n"
 				"--help, -h			summon a sentient, angry tuba\n\n"
 				"More information available in README.md.\n";
 			return false; //exit after printing help
@@ -483,25 +520,51 @@ int main(int argc, char* argv[])
 	//always close the log on exit
 	atexit(&onExit);
 
+	// MameNames only parses its XML files, it doesn't need to wait for the window.
+	// The resource manager singleton is created first as both threads use it
+	ResourceManager::getInstance();
+	std::thread mameNamesThread([]
+	{
+		StartupTrace::Phase phase("mamenames");
+		MameNames::init();
+	});
+
+	StartupTrace::Phase initPhase("init");
 	Window window;
 	SystemScreenSaver screensaver(&window);
 	PowerSaver::init();
 	ViewController::init(&window);
 	CollectionSystemManager::init(&window);
-	MameNames::init();
 	window.pushGui(ViewController::get());
 
 	TextureData::OPTIMIZEVRAM = Settings::getInstance()->getBool("OptimizeVRAM");
+	TextureData::RESUMECACHE = Settings::getInstance()->getBool("ResumeCache");
 	GuiComponent::ALLOWANIMATIONS = Settings::getInstance()->getString("TransitionStyle") != "instant";
 
+	// keep the copies used by the hot paths in sync with the settings
+	Settings::getInstance()->addChangedListener([](const std::string& name)
+	{
+		if (name == "OptimizeVRAM")
+			TextureData::OPTIMIZEVRAM = Settings::getInstance()->getBool("OptimizeVRAM");
+		else if (name == "ResumeCache")
+			TextureData::RESUMECACHE = Settings::getInstance()->getBool("ResumeCache");
+		else if (name == "TransitionStyle")
+			GuiComponent::ALLOWANIMATIONS = Settings::getInstance()->getString("TransitionStyle") != "instant";
+	});
+
 	bool splashScreen = Settings::getInstance()->getBool("SplashScreen");
 	bool splashScreenProgress = Settings::getInstance()->getBool("SplashScreenProgress");
 
+	initPhase.end();
+
 	if (!scrape_cmdline)
 	{
+		StartupTrace::Phase windowPhase("window");
+
 		if(!window.init(true))
 		{
 			LOG(LogError) << "Window failed to initialize!";
+			mameNamesThread.join();
 			return 1;
 		}
 
@@ -509,6 +572,11 @@ int main(int argc, char* argv[])
 			window.renderLoadingScreen(_("Loading..."));
 	}
 
+	// Game names of arcade systems are resolved while loading the systems
+	mameNamesThread.join();
+
+	StartupTrace::Phase systemsPhase("systems", "mamenames");
+
 	const char* errorMsg = NULL;
 	if(!loadSystemConfigFile(&window, &errorMsg))
 	{
@@ -533,6 +601,8 @@ int main(int argc, char* argv[])
 			}));
 	}
 
+	systemsPhase.end();
+
 	//run the command line scraper then quit
 	if (scrape_cmdline)
 		return run_scraper_cmdline();
@@ -549,7 +619,10 @@ int main(int argc, char* argv[])
 	// this makes for no delays when accessing content, but a longer startup time
 
 	if (Settings::getInstance()->getBool("PreloadUI"))
+	{
+		StartupTrace::Phase preloadPhase("preload");
 		ViewController::get()->preload();
+	}
 	
 	if (splashScreen && splashScreenProgress)	
 		window.renderLoadingScreen(_("Starting UI"));
@@ -557,6 +630,8 @@ int main(int argc, char* argv[])
 	//choose which GUI to open depending on if an input configuration already exists
 	if (errorMsg == NULL)
 	{
+		StartupTrace::Phase startPhase("start");
+
 		if (Utils::FileSystem::exists(InputManager::getConfigPath()) && InputManager::getInstance()->getNumConfiguredDevices() > 0)
 			ViewController::get()->goToStart(true);
 		else
@@ -567,6 +642,7 @@ int main(int argc, char* argv[])
 	SDL_JoystickEventState(SDL_ENABLE);
 
 	window.endRenderLoadingScreen();
+	StartupTrace::writeReport();
 
 	if (Settings::getInstance()->getBool("audio.bgmusic"))
 		AudioManager::getInstance()->playRandomMusic();
@@ -587,18 +663,33 @@ int main(int argc, char* argv[])
 	int timeLimit = (1000 / displayFrequency) - 6;	 // Margin for vsync
 #endif
 
+	// a script that can't be played must not look like a successful benchmark run
+	bool inputScriptFailed = false;
+
+	InputScript* inputScript = nullptr;
+	if (!gInputScript.empty())
+	{
+		inputScript = new InputScript();
+		if (!inputScript->load(gInputScript))
+		{
+			delete inputScript;
+			inputScript = nullptr;
+			inputScriptFailed = true;
+		}
+	}
+
 	int lastTime = SDL_GetTicks();
 	int ps_time = SDL_GetTicks();
 	int exitMode = 0;
 
-	bool running = true;
+	bool running = !inputScriptFailed;
 
 	while(running)
 	{
 		int processStart = SDL_GetTicks();
 
 		SDL_Event event;
-		bool ps_standby = PowerSaver::getState() && (int) SDL_GetTicks() - ps_time > PowerSaver::getMode();
+		bool ps_standby = inputScript == nullptr && PowerSaver::getState() && (int) SDL_GetTicks() - ps_time > PowerSaver::getMode();
 
 		if (ps_standby ? SDL_WaitEventTimeout(&event, PowerSaver::getTimeout()) : SDL_PollEvent(&event))
 		{
@@ -608,6 +699,19 @@ int main(int argc, char* argv[])
 
 				if (event.type == SDL_QUIT)
 					running = false;
+				else if (event.type == SDL_WINDOWEVENT)
+				{
+					// the window content may be lost : redraw it even if nothing changed
+					switch (event.window.event)
+					{
+					case SDL_WINDOWEVENT_EXPOSED:
+					case SDL_WINDOWEVENT_RESTORED:
+					case SDL_WINDOWEVENT_SIZE_CHANGED:
+					case SDL_WINDOWEVENT_SHOWN:
+						window.invalidate();
+						break;
+					}
+				}
 			} 
 			while(SDL_PollEvent(&event));
 
@@ -641,12 +745,29 @@ int main(int argc, char* argv[])
 		if (deltaTime < 0)
 			deltaTime = 1000;
 
+		if (inputScript != nullptr)
+		{
+			if (!inputScript->update(&window))
+			{
+				running = false;
+				inputScriptFailed = inputScript->hasFailed();
+			}
+
+			deltaTime = InputScript::getFrameTime();
+		}
+
 		processAudioTitles(&window);
 
 		window.update(deltaTime);
+
+		if (window.isIdleFrame())
+		{
+			// nothing changed on screen : keep the last presented frame and give the CPU/GPU some rest
+			SDL_Delay(16);
+			continue;
+		}
+
 		window.render();
-		
-		Log::flush();
 
 		int processDuration = SDL_GetTicks() - processStart;
 		
@@ -673,6 +794,9 @@ int main(int argc, char* argv[])
 */
 	}
 
+	if (inputScript != nullptr)
+		delete inputScript;
+
 	ThreadedScraper::stop();
 
 	while(window.peekGui() != ViewController::get())
@@ -696,5 +820,5 @@ int main(int argc, char* argv[])
 
 	LOG(LogInfo) << "EmulationStation cleanly shutting down.";
 
-	return 0;
+	return inputScriptFailed ? 1 : 0;
 }
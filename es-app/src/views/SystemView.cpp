@@ -10,6 +10,8 @@
 #include "Window.h"
 #include "AudioManager.h"
 #include "components/VideoComponent.h"
+#include "resources/TextureResource.h"
+#include <algorithm>
 
 // buffer values for scrolling velocity (left, stopped, right)
 const int logoBuffersLeft[] = { -5, -2, -1 };
@@ -47,6 +49,8 @@ SystemView::~SystemView()
 
 void SystemView::clearEntries()
 {
+	clearBackgroundCache();
+
 	for (int i = 0; i < mEntries.size(); i++)
 	{
 		for (auto extra : mEntries[i].data.backgroundExtras)
@@ -63,70 +67,29 @@ class SystemRandomPlaylist : public IPlaylist
 public:
 	enum PlaylistType
 	{
-		IMAGE,
-		THUMBNAIL,
-		MARQUEE,
-		VIDEO
+		IMAGE = MEDIA_IMAGE,
+		THUMBNAIL = MEDIA_THUMBNAIL,
+		MARQUEE = MEDIA_MARQUEE,
+		VIDEO = MEDIA_VIDEO
 	};
 
 	SystemRandomPlaylist(SystemData* system, PlaylistType type)
 	{
-		mFirstRun = true;
 		mSystem = system;
 		mType = type;
 	}
 		
 	std::string getNextItem()
 	{
-		if (mFirstRun)
-		{
-			std::vector<FileData*> files = mSystem->getRootFolder()->getFilesRecursive(GAME, false);
-
-			for (auto file : files)
-			{
-				switch (mType)
-				{
-				case IMAGE:
-					if (!file->getImagePath().empty())
-						mPaths.push_back(file->getImagePath());
-					break;
-
-				case THUMBNAIL:
-					if (!file->getThumbnailPath().empty())
-						mPaths.push_back(file->getThumbnailPath());
-					break;
-
-				case MARQUEE:
-					if (!file->getMarqueePath().empty())
-						mPaths.push_back(file->getMarqueePath());
-					break;
-
-				case VIDEO:
-					if (!file->getVideoPath().empty())
-						mPaths.push_back(file->getVideoPath());
-					break;
-				}
-			}
-
-			mFirstRun = false;
-		}
-
-		int idx = (int) ((float) rand() * mPaths.size()) / float(RAND_MAX);
-				
-		if (idx >= 0 && idx < mPaths.size())
-			return mPaths[idx];
-
-		return "";
+		std::string path;
+		// random playlists pick among all the games, filtered or not
+		mSystem->getMediaCatalogue(false)->pickRandom((MediaType)mType, path);
+		return path;
 	}
 
-
-
 private:
 	SystemData*		mSystem;
-	bool			mFirstRun;
 	PlaylistType	mType;
-
-	std::vector<std::string> mPaths;
 };
 
 void SystemView::populate()
@@ -431,6 +394,24 @@ void SystemView::update(int deltaTime)
 	GuiComponent::update(deltaTime);
 }
 
+bool SystemView::isAnimating()
+{
+	if (IList<SystemViewData, SystemData*>::isAnimating())
+		return true;
+
+	for (auto it = mEntries.cbegin(); it != mEntries.cend(); it++)
+	{
+		if (it->data.logo != nullptr && it->data.logo->isAnimating())
+			return true;
+
+		for (auto extra : it->data.backgroundExtras)
+			if (extra->isAnimating())
+				return true;
+	}
+
+	return false;
+}
+
 void SystemView::onCursorChanged(const CursorState& /*state*/)
 {
 	if (mLastSystem != getSelected()) {
@@ -625,11 +606,18 @@ void SystemView::render(const Transform4x4f& parentTrans)
 	auto systemInfoZIndex = mSystemInfo.getZIndex();
 	auto minMax = std::minmax(mCarousel.zIndex, systemInfoZIndex);
 
-	renderExtras(trans, INT16_MIN, minMax.first);
-	// renderFade(trans);
+	bool useBackgroundCache = canCacheBackground(trans, minMax.first);
+	if (!useBackgroundCache || !renderCachedBackground(trans))
+	{
+		renderExtras(trans, INT16_MIN, minMax.first);
+		// renderFade(trans);
 
-	if (mStaticBackground != nullptr)
-		mStaticBackground->render(trans);
+		if (mStaticBackground != nullptr)
+			mStaticBackground->render(trans);
+
+		if (useBackgroundCache)
+			cacheBackground();
+	}
 
 	if (mCarousel.zIndex > mSystemInfo.getZIndex()) {
 		renderInfoBar(trans);
@@ -984,6 +972,99 @@ void SystemView::renderExtras(const Transform4x4f& trans, float lower, float upp
 	Renderer::popClipRect();
 }
 
+#define MAX_CACHED_BACKGROUNDS 3
+
+bool SystemView::canCacheBackground(const Transform4x4f& trans, float upper)
+{
+	// the captured layer must match the screen exactly : no rotation, no offset, no scrolling, no fading
+	if (Renderer::getScreenRotate() != 0 || mCursor < 0 || mCursor >= (int)mEntries.size())
+		return false;
+
+	if (trans.translation() != Vector3f::Zero() || trans.r0().x() != 1 || trans.r0().y() != 0 || trans.r1().x() != 0 || trans.r1().y() != 1)
+		return false;
+
+	if (mExtrasFadeOpacity != 0 || mExtrasCamOffset != (float)mCursor || getScrollingVelocity() != 0 || TextureResource::hasPendingLoads())
+		return false;
+
+	if (mStaticBackground != nullptr && (mStaticBackground->isAnimating() || !mStaticBackground->isFadedIn()))
+		return false;
+
+	// a capture of a blank or half faded image would be reused until the view is hidden
+	for (auto extra : mEntries.at(mCursor).data.backgroundExtras)
+	{
+		if (extra->getZIndex() >= upper || !extra->isVisible())
+			continue;
+
+		if (extra->isAnimating() || (extra->isKindOf<ImageComponent>() && !((ImageComponent*)extra)->isFadedIn()))
+			return false;
+	}
+
+	return true;
+}
+
+bool SystemView::renderCachedBackground(const Transform4x4f& trans)
+{
+	SystemData* system = mEntries.at(mCursor).object;
+
+	auto it = std::find_if(mBackgroundCache.begin(), mBackgroundCache.end(), [system](const BackgroundLayer& layer) { return layer.system == system; });
+	if (it == mBackgroundCache.end())
+		return false;
+
+	BackgroundLayer layer = *it;
+	mBackgroundCache.erase(it);
+	mBackgroundCache.insert(mBackgroundCache.begin(), layer);
+
+	// the copied texture is upside down
+	const float w = mSize.x();
+	const float h = mSize.y();
+
+	Renderer::Vertex vertices[4] = {
+		{ { 0, 0 }, { 0, 1 }, 0xFFFFFFFF },
+		{ { 0, h }, { 0, 0 }, 0xFFFFFFFF },
+		{ { w, 0 }, { 1, 1 }, 0xFFFFFFFF },
+		{ { w, h }, { 1, 0 }, 0xFFFFFFFF }
+	};
+
+	Renderer::setMatrix(trans);
+	Renderer::bindTexture(layer.texture);
+	Renderer::drawTriangleStrips(&vertices[0], 4, Renderer::Blend::ONE, Renderer::Blend::ZERO);
+	Renderer::bindTexture(0);
+
+	return true;
+}
+
+void SystemView::cacheBackground()
+{
+	const unsigned int w = (unsigned int)mSize.x();
+	const unsigned int h = (unsigned int)mSize.y();
+
+	BackgroundLayer layer;
+	layer.system = mEntries.at(mCursor).object;
+
+	if (mBackgroundCache.size() >= MAX_CACHED_BACKGROUNDS)
+	{
+		// recycle the least recently used texture
+		layer.texture = mBackgroundCache.back().texture;
+		mBackgroundCache.pop_back();
+	}
+	else
+		layer.texture = Renderer::createTexture(Renderer::Texture::RGBA, false, false, w, h, nullptr);
+
+	if (layer.texture == 0)
+		return;
+
+	Renderer::copyToTexture(layer.texture, Renderer::getScreenOffsetX(), Renderer::getScreenOffsetY(), w, h);
+	mBackgroundCache.insert(mBackgroundCache.begin(), layer);
+}
+
+void SystemView::clearBackgroundCache()
+{
+	for (auto layer : mBackgroundCache)
+		Renderer::destroyTexture(layer.texture);
+
+	mBackgroundCache.clear();
+}
+
 void SystemView::renderFade(const Transform4x4f& trans)
 {
 	// fade extras if necessary
@@ -1117,6 +1198,7 @@ void SystemView::onHide()
 {
 	GuiComponent::onHide();
 	mShowing = false;
+	clearBackgroundCache(); // the renderer may be torn down while we're hidden
 	updateExtras([this](GuiComponent* p) { p->onHide(); });
 }
 
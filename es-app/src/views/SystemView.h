@@ -63,6 +63,7 @@ public:
 	bool input(InputConfig* config, Input input) override;
 	void update(int deltaTime) override;
 	void render(const Transform4x4f& parentTrans) override;
+	bool isAnimating() override;
 
 	void onThemeChanged(const std::shared_ptr<ThemeData>& theme);
 
@@ -91,6 +92,19 @@ private:
 	void renderInfoBar(const Transform4x4f& trans);
 	void renderFade(const Transform4x4f& trans);
 
+	// Background layer cache : the extras below the carousel are captured once per system and drawn as a single quad
+	bool canCacheBackground(const Transform4x4f& trans, float upper);
+	bool renderCachedBackground(const Transform4x4f& trans);
+	void cacheBackground();
+	void clearBackgroundCache();
+
+	struct BackgroundLayer
+	{
+		SystemData*  system;
+		unsigned int texture;
+	};
+
+	std::vector<BackgroundLayer> mBackgroundCache; // most recently used first
 
 	SystemViewCarousel	mCarousel;
 	TextComponent		mSystemInfo;
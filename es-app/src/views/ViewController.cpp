@@ -4,6 +4,7 @@
 #include "animations/LambdaAnimation.h"
 #include "animations/LaunchAnimation.h"
 #include "animations/MoveCameraAnimation.h"
+#include "components/VideoVlcComponent.h"
 #include "guis/GuiMenu.h"
 #include "views/gamelist/DetailedGameListView.h"
 #include "views/gamelist/IGameListView.h"
@@ -13,13 +14,23 @@
 #include "views/UIModeController.h"
 #include "FileFilterIndex.h"
 #include "Log.h"
+#include "MemoryBudget.h"
 #include "Settings.h"
 #include "SystemData.h"
 #include "Window.h"
 #include "AudioManager.h"
 #include "utils/ThreadPool.h"
+#include <SDL_timer.h>
+#include <algorithm>
 #include <mutex>
 
+// Rough size of a cached gamelist view : its images are reported by the textures
+#define VIEW_BASE_SIZE		(64 * 1024)
+#define VIEW_ENTRY_SIZE		512
+
+// Views shown more recently may still be drawn by a transition
+#define VIEW_EVICTION_DELAY	10000
+
 ViewController* ViewController::sInstance = NULL;
 
 ViewController* ViewController::get()
@@ -38,14 +49,77 @@ ViewController::ViewController(Window* window)
 	: GuiComponent(window), mCurrentView(nullptr), mCamera(Transform4x4f::Identity()), mFadeOpacity(0), mLockInput(false)
 {
 	mState.viewing = NOTHING;
+
+	MemoryBudget::Consumer views;
+	views.name = "Views";
+	views.priority = 3;
+	views.getSize = [this] { return getGameListViewsMemUsage(); };
+	views.getLastUse = [this]
+	{
+		unsigned int lastUse = 0;
+		for (auto it : mGameListViewsUsage)
+			lastUse = std::max(lastUse, it.second.lastUse);
+
+		return lastUse;
+	};
+	views.evict = [this](size_t bytes) { return evictGameListViews(bytes); };
+	mMemoryConsumer = MemoryBudget::add(views);
 }
 
 ViewController::~ViewController()
 {
+	MemoryBudget::remove(mMemoryConsumer);
+
 	assert(sInstance == this);
 	sInstance = NULL;
 }
 
+size_t ViewController::getGameListViewsMemUsage()
+{
+	size_t total = 0;
+	for (auto it : mGameListViewsUsage)
+		total += it.second.estimatedSize;
+
+	return total;
+}
+
+size_t ViewController::evictGameListViews(size_t bytes)
+{
+	unsigned int now = SDL_GetTicks();
+
+	std::vector<std::pair<SystemData*, GameListViewUsage>> candidates;
+	for (auto it : mGameListViewsUsage)
+	{
+		if (it.first == mState.system || now - it.second.lastUse < VIEW_EVICTION_DELAY)
+			continue;
+
+		auto view = mGameListViews.find(it.first);
+		if (view != mGameListViews.cend() && view->second != mCurrentView)
+			candidates.push_back(it);
+	}
+
+	std::sort(candidates.begin(), candidates.end(), [](const std::pair<SystemData*, GameListViewUsage>& a, const std::pair<SystemData*, GameListViewUsage>& b) { return a.second.lastUse < b.second.lastUse; });
+
+	size_t freed = 0;
+	for (auto candidate : candidates)
+	{
+		if (freed >= bytes)
+			break;
+
+		LOG(LogDebug) << "ViewController : evicting the gamelist view of " << candidate.first->getName();
+
+		// like reloadAll, the cursor is kept : the game may be deleted meanwhile, it's found again by its path
+		FileData* cursor = mGameListViews[candidate.first]->getCursor();
+		if (cursor != nullptr && !cursor->isPlaceHolder())
+			mEvictedCursors[candidate.first] = cursor->getPath();
+
+		removeGameListView(candidate.first);
+		freed += candidate.second.estimatedSize;
+	}
+
+	return freed;
+}
+
 void ViewController::goToStart(bool forceImmediate)
 {
 	bool hideSystemView = Settings::getInstance()->getBool("HideSystemView");
@@ -158,6 +232,10 @@ void ViewController::goToGameList(SystemData* system, bool forceImmediate)
 	if (mCurrentView)
 		mCurrentView->onShow();
 
+	auto usage = mGameListViewsUsage.find(system);
+	if (usage != mGameListViewsUsage.cend())
+		usage->second.lastUse = SDL_GetTicks();
+
 	playViewTransition(forceImmediate);
 }
 
@@ -221,6 +299,12 @@ void ViewController::playViewTransition(bool forceImmediate)
 
 void ViewController::onFileChanged(FileData* file, FileChangeType change)
 {
+	if (file->getType() == GAME && (change == FILE_ADDED || change == FILE_METADATA_CHANGED))
+	{
+		FileData* sourceFile = file->getSourceFileData();
+		sourceFile->getSystem()->updateCatalogue(sourceFile);
+	}
+
 	auto it = mGameListViews.find(file->getSystem());
 	if(it != mGameListViews.cend())
 		it->second->onFileChanged(file, change);
@@ -290,6 +374,8 @@ void ViewController::removeGameListView(SystemData* system)
 		exists->second.reset();
 		mGameListViews.erase(system);
 	}
+
+	mGameListViewsUsage.erase(system);
 }
 
 std::shared_ptr<IGameListView> ViewController::getGameListView(SystemData* system, bool loadIfnull)
@@ -441,6 +527,22 @@ std::shared_ptr<IGameListView> ViewController::getGameListView(SystemData* syste
 	addChild(view.get());
 
 	mGameListViews[system] = view;
+
+	auto evictedCursor = mEvictedCursors.find(system);
+	if (evictedCursor != mEvictedCursors.cend())
+	{
+		FileData* cursor = system->getRootFolder()->FindByPath(evictedCursor->second);
+		if (cursor != nullptr)
+			view->setCursor(cursor);
+
+		mEvictedCursors.erase(evictedCursor);
+	}
+
+	GameListViewUsage usage;
+	usage.lastUse = SDL_GetTicks();
+	usage.estimatedSize = VIEW_BASE_SIZE + (size_t)system->getDisplayedGameCount() * VIEW_ENTRY_SIZE;
+	mGameListViewsUsage[system] = usage;
+
 	return view;
 }
 
@@ -506,6 +608,16 @@ void ViewController::update(int deltaTime)
 	updateSelf(deltaTime);
 }
 
+bool ViewController::isAnimating()
+{
+	// only the current view is updated, the other views are frozen
+	for(unsigned char i = 0; i < MAX_ANIMATIONS; i++)
+		if(isAnimationPlaying(i))
+			return true;
+
+	return mCurrentView != nullptr && mCurrentView->isAnimating();
+}
+
 void ViewController::render(const Transform4x4f& parentTrans)
 {
 	Transform4x4f trans = mCamera * parentTrans;
@@ -598,6 +710,7 @@ void ViewController::reloadGameListView(IGameListView* view, bool reloadTheme)
 			FileData* cursor = view->getCursor();
 
 			mGameListViews.erase(it);
+			mGameListViewsUsage.erase(system);
 
 			if (reloadTheme)
 				system->loadTheme();
@@ -650,6 +763,7 @@ void ViewController::reloadAll(Window* window)
 		cursorMap[it->first] = it->second->getCursor();
 
 	mGameListViews.clear();
+	mGameListViewsUsage.clear();
 
 	for (auto it = SystemData::sSystemVector.cbegin(); it != SystemData::sSystemVector.cend(); it++)
 	{
@@ -676,6 +790,10 @@ void ViewController::reloadAll(Window* window)
 
 	pool.wait();
 
+	// drop the parsed theme files that no system is using anymore ( previous theme set )
+	ThemeData::purgeDocumentCache();
+	VideoVlcComponent::clearVideoSizeCache();
+
 	// load themes, create gamelistviews and reset filters
 	for(auto it = cursorMap.cbegin(); it != cursorMap.cend(); it++)
 	{
@@ -48,6 +48,7 @@ public:
 	bool input(InputConfig* config, Input input) override;
 	void update(int deltaTime) override;
 	void render(const Transform4x4f& parentTrans) override;
+	bool isAnimating() override;
 
 	enum ViewMode
 	{
@@ -100,6 +101,20 @@ private:
 
 	std::shared_ptr<GuiComponent> mCurrentView;
 	std::map< SystemData*, std::shared_ptr<IGameListView> > mGameListViews;
+
+	// Cached gamelist views are reported to the memory budget, and the least recently shown are evicted under pressure
+	struct GameListViewUsage
+	{
+		unsigned int lastUse;
+		size_t estimatedSize;
+	};
+
+	std::map< SystemData*, GameListViewUsage > mGameListViewsUsage;
+	std::map< SystemData*, std::string > mEvictedCursors; // path of the cursor of evicted views, restored when they're created again
+	int mMemoryConsumer;
+
+	size_t getGameListViewsMemUsage();
+	size_t evictGameListViews(size_t bytes);
 	std::shared_ptr<SystemView> mSystemListView;
 
 	Transform4x4f mCamera;
@@ -18,6 +18,8 @@ BasicGameListView::BasicGameListView(Window* window, FolderData* root)
 	addChild(&mList);		
 
 	populateList(mRoot->getChildrenListToDisplay());
+
+	mList.setCursorChangedCallback([&](const CursorState& /*state*/) { fireGameSelectedEvent(); });
 }
 
 void BasicGameListView::onShow()
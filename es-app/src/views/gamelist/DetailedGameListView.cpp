@@ -29,7 +29,7 @@ DetailedGameListView::DetailedGameListView(Window* window, FolderData* root) :
 	mList.setPosition(mSize.x() * (0.50f + padding), mList.getPosition().y());
 	mList.setSize(mSize.x() * (0.50f - padding), mList.getSize().y());
 	mList.setAlignment(TextListComponent<FileData*>::ALIGN_LEFT);
-	mList.setCursorChangedCallback([&](const CursorState& /*state*/) { updateInfoPanel(); });
+	mList.setCursorChangedCallback([&](const CursorState& /*state*/) { updateInfoPanel(); fireGameSelectedEvent(); });
 
 	createImage();
 
@@ -360,6 +360,13 @@ void DetailedGameListView::updateInfoPanel()
 			if (!mVideo->setVideo(file->getVideoPath()))
 				mVideo->setDefaultVideo();
 
+			// Read the dimensions of the neighbour videos ahead, so they start quicker when the cursor moves
+			if (mList.size() > 1)
+			{
+				mVideo->prefetchVideoInfo(mList.getObjectFromCursor(1)->getVideoPath());
+				mVideo->prefetchVideoInfo(mList.getObjectFromCursor(-1)->getVideoPath());
+			}
+
 			std::string snapShot = imagePath;
 
 			auto src = mVideo->getSnapshotSource();
@@ -33,7 +33,7 @@ GridGameListView::GridGameListView(Window* window, FolderData* root, const std::
 	mGrid.setGridSizeOverride(gridSize);
 	mGrid.setPosition(mSize.x() * 0.1f, mSize.y() * 0.1f);
 	mGrid.setDefaultZIndex(20);
-	mGrid.setCursorChangedCallback([&](const CursorState& /*state*/) { updateInfoPanel(); });
+	mGrid.setCursorChangedCallback([&](const CursorState& /*state*/) { updateInfoPanel(); fireGameSelectedEvent(); });
 	addChild(&mGrid);
 
 	// metadata labels + values
@@ -527,6 +527,13 @@ void GridGameListView::updateInfoPanel()
 			if (!mVideo->setVideo(file->getVideoPath()))
 				mVideo->setDefaultVideo();
 
+			// Read the dimensions of the neighbour videos ahead, so they start quicker when the cursor moves
+			if (mGrid.size() > 1)
+			{
+				mVideo->prefetchVideoInfo(mGrid.getObjectFromCursor(1)->getVideoPath());
+				mVideo->prefetchVideoInfo(mGrid.getObjectFromCursor(-1)->getVideoPath());
+			}
+
 			std::string snapShot = imagePath;
 
 			auto src = mVideo->getSnapshotSource();
@@ -3,6 +3,7 @@
 #include "views/UIModeController.h"
 #include "views/ViewController.h"
 #include "CollectionSystemManager.h"
+#include "Scripting.h"
 #include "Settings.h"
 #include "Sound.h"
 #include "SystemData.h"
@@ -205,13 +206,12 @@ std::vector<std::string> ISimpleGameListView::getEntriesLetters()
 	return letters;
 }
 
+void ISimpleGameListView::fireGameSelectedEvent()
+{
+	FileData* cursor = getCursor();
+	if (cursor == nullptr || cursor->getType() != GAME)
+		return;
 
-
-
-
-
-
-
-
-
-
+	// scripts run in the background, and scrolling through the list only runs them for the last game selected
+	Scripting::fireEvent("game-selected", cursor->getSystem()->getName(), cursor->getPath());
+}
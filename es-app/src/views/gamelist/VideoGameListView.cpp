@@ -44,7 +44,7 @@ VideoGameListView::VideoGameListView(Window* window, FolderData* root) :
 	mList.setPosition(mSize.x() * (0.50f + padding), mList.getPosition().y());
 	mList.setSize(mSize.x() * (0.50f - padding), mList.getSize().y());
 	mList.setAlignment(TextListComponent<FileData*>::ALIGN_LEFT);
-	mList.setCursorChangedCallback([&](const CursorState& /*state*/) { updateInfoPanel(); });
+	mList.setCursorChangedCallback([&](const CursorState& /*state*/) { updateInfoPanel(); fireGameSelectedEvent(); });
 
 	// Marquee
 	mMarquee.setOrigin(0.5f, 0.5f);
@@ -309,6 +309,14 @@ void VideoGameListView::updateInfoPanel()
 		{
 			mVideo->setDefaultVideo();
 		}
+
+		// Read the dimensions of the neighbour videos ahead, so they start quicker when the cursor moves
+		if (mList.size() > 1)
+		{
+			mVideo->prefetchVideoInfo(mList.getObjectFromCursor(1)->getVideoPath());
+			mVideo->prefetchVideoInfo(mList.getObjectFromCursor(-1)->getVideoPath());
+		}
+
 		mVideoPlaying = true;
 		
 		std::string snapShot = file->getThumbnailPath();
@@ -3,11 +3,12 @@
 #include "Settings.h"
 #include "utils/FileSystemUtil.h"
 
-#include <fstream>
+#include <mutex>
+#include <sstream>
 
-std::map<std::string, std::string> EsLocale::mItems;
-std::string EsLocale::mCurrentLanguage = "en";
-bool EsLocale::mCurrentLanguageLoaded = true; // By default, 'en' is considered loaded
+std::atomic<bool> EsLocale::mCurrentLanguageLoaded(true); // By default, 'en' is considered loaded
+
+static std::mutex sLoadLock;
 
 // List of all possible plural forms here
 // https://github.com/translate/l10n-guide/blob/master/docs/l10n/pluralforms.rst
@@ -35,75 +36,124 @@ PluralRule rules[] = {
 	{ "kw", "n==1?0:n==2?1:n==3?2:3", [](int n) { return (n == 1) ? 0 : (n == 2) ? 1 : (n == 3) ? 2 : 3; } }
 };
 
-PluralRule EsLocale::mPluralRule = rules[0];
-
-const std::string EsLocale::getText(const std::string text)
+// The translations of a language. Never modified once published : loading another language makes a new one
+struct EsLocale::Catalogue
 {
-	checkLocalisationLoaded();
+	Catalogue(int _generation, const std::string& _language) : generation(_generation), language(_language), pluralRule(rules[0]) { }
+
+	int generation; // invalidates the call site caches of the previous catalogues
+	std::string language;
+	PluralRule pluralRule;
+	std::unordered_map<std::string, std::string> items;
+};
 
-	auto item = mItems.find(text);
-	if (item != mItems.cend())
+std::shared_ptr<const EsLocale::Catalogue> EsLocale::mCatalogue = std::make_shared<EsLocale::Catalogue>(1, "en");
+
+static const std::string& findText(const std::unordered_map<std::string, std::string>& items, const std::string& text)
+{
+	auto item = items.find(text);
+	if (item != items.cend())
 		return item->second;
 
 	return text;
 }
 
-const std::string EsLocale::nGetText(const std::string msgid, const std::string msgid_plural, int n)
+const std::string EsLocale::getText(const std::string& text)
+{
+	std::shared_ptr<const Catalogue> catalogue = getCatalogue();
+	return findText(catalogue->items, text);
+}
+
+const std::string EsLocale::getTextFromLiteral(const char* text, LiteralCache* cache)
+{
+	std::shared_ptr<const Catalogue> catalogue = getCatalogue();
+
+	std::shared_ptr<const LiteralTranslation> translation = std::atomic_load(&cache->translation);
+	if (translation != nullptr && translation->generation == catalogue->generation && translation->msgid == text)
+		return translation->text;
+
+	std::shared_ptr<LiteralTranslation> found = std::make_shared<LiteralTranslation>();
+	found->generation = catalogue->generation;
+	found->msgid = text;
+	found->text = findText(catalogue->items, found->msgid);
+
+	std::atomic_store(&cache->translation, std::shared_ptr<const LiteralTranslation>(found));
+	return found->text;
+}
+
+const std::string EsLocale::nGetText(const std::string& msgid, const std::string& msgid_plural, int n)
 {	
-	if (mCurrentLanguage.empty() || mCurrentLanguage == "en") // English default
-		return n != 1 ? msgid_plural : msgid;
+	std::shared_ptr<const Catalogue> catalogue = getCatalogue();
 
-	if (mPluralRule.rule.empty())
-		return n != 1 ? getText(msgid_plural) : getText(msgid);		
+	if (catalogue->language.empty() || catalogue->language == "en") // English default
+		return n != 1 ? msgid_plural : msgid;
 
-	checkLocalisationLoaded();
+	if (catalogue->pluralRule.rule.empty())
+		return n != 1 ? findText(catalogue->items, msgid_plural) : findText(catalogue->items, msgid);
 
-	int pluralId = mPluralRule.evaluate(n);
+	int pluralId = catalogue->pluralRule.evaluate(n);
 	if (pluralId == 0)
-		return getText(msgid);
+		return findText(catalogue->items, msgid);
 			
-	auto item = mItems.find(std::to_string(pluralId) + "@" + msgid_plural);
-	if (item != mItems.cend())
+	auto item = catalogue->items.find(std::to_string(pluralId) + "@" + msgid_plural);
+	if (item != catalogue->items.cend())
 		return item->second;
 
-	item = mItems.find(msgid_plural);
-	if (item != mItems.cend())
-		return item->second;
+	return findText(catalogue->items, msgid_plural);
+}
 
-	return msgid_plural;
+const std::string EsLocale::getLanguage()
+{
+	return std::atomic_load(&mCatalogue)->language;
 }
 
 const std::vector<PluralRule> pluralRules(rules, rules + sizeof(rules) / sizeof(rules[0]));
 
-void EsLocale::checkLocalisationLoaded()
+// The catalogue of the language in the settings, loaded the first time it's needed
+std::shared_ptr<const EsLocale::Catalogue> EsLocale::getCatalogue()
 {
-	if (mCurrentLanguageLoaded)
-	{
-		if (Settings::getInstance()->getString("Language") == mCurrentLanguage)
-			return;
+	static const std::string* language = Settings::getInstance()->getStringSlot("Language");
 
-		mCurrentLanguage = Settings::getInstance()->getString("Language");
-	}
+	std::shared_ptr<const Catalogue> catalogue = std::atomic_load(&mCatalogue);
+	if (mCurrentLanguageLoaded && catalogue->language == *language)
+		return catalogue;
+
+	std::unique_lock<std::mutex> lock(sLoadLock);
+
+	// another thread may have loaded it in the meantime
+	catalogue = std::atomic_load(&mCatalogue);
+	if (mCurrentLanguageLoaded && catalogue->language == *language)
+		return catalogue;
 
 	mCurrentLanguageLoaded = true;
-	mPluralRule = rules[0];
 
-	mItems.clear();
+	catalogue = loadCatalogue(*language, catalogue->generation + 1);
+	std::atomic_store(&mCatalogue, catalogue);
 
-	std::string xmlpath = ResourceManager::getInstance()->getResourcePath(":/locale/" + mCurrentLanguage + "/emulationstation2.po");
-	if (!Utils::FileSystem::exists(xmlpath))
-		xmlpath = ResourceManager::getInstance()->getResourcePath(":/locale/" + mCurrentLanguage + "/LC_MESSAGES/emulationstation2.po");
+	return catalogue;
+}
+
+std::shared_ptr<const EsLocale::Catalogue> EsLocale::loadCatalogue(const std::string& language, int generation)
+{
+	std::shared_ptr<Catalogue> catalogue = std::make_shared<Catalogue>(generation, language);
+
+	// resolved by the resource manager, the translations can be in the resource archive
+	std::shared_ptr<ResourceManager>& rm = ResourceManager::getInstance();
 
-	if (!Utils::FileSystem::exists(xmlpath))
+	std::string xmlpath = ":/locale/" + language + "/emulationstation2.po";
+	if (!rm->fileExists(xmlpath))
+		xmlpath = ":/locale/" + language + "/LC_MESSAGES/emulationstation2.po";
+
+	if (!rm->fileExists(xmlpath))
 	{
-		auto shortNameDivider = mCurrentLanguage.find("_");
+		auto shortNameDivider = language.find("_");
 		if (shortNameDivider != std::string::npos)
 		{
-			auto shortName = mCurrentLanguage.substr(0, shortNameDivider);
+			auto shortName = language.substr(0, shortNameDivider);
 
-			xmlpath = ResourceManager::getInstance()->getResourcePath(":/locale/" + shortName + "/emulationstation2.po");
-			if (!Utils::FileSystem::exists(xmlpath))
-				xmlpath = ResourceManager::getInstance()->getResourcePath(":/locale/" + shortName + "/LC_MESSAGES/emulationstation2.po");
+			xmlpath = ":/locale/" + shortName + "/emulationstation2.po";
+			if (!rm->fileExists(xmlpath))
+				xmlpath = ":/locale/" + shortName + "/LC_MESSAGES/emulationstation2.po";
 		}
 	}
 
@@ -112,7 +162,9 @@ void EsLocale::checkLocalisationLoaded()
 	
 	std::string line;
 
-	std::ifstream file(xmlpath);
+	const ResourceData data = rm->getFileData(xmlpath);
+
+	std::istringstream file(data.ptr != nullptr ? std::string((const char*)data.ptr.get(), data.length) : std::string());
 	while (std::getline(file, line))
 	{
 		if (line.find("\"Plural-Forms:") == 0)
@@ -149,7 +201,7 @@ void EsLocale::checkLocalisationLoaded()
 				{
 					if (plural == iter->rule)
 					{
-						mPluralRule = *iter;
+						catalogue->pluralRule = *iter;
 						break;
 					}
 				}
@@ -202,19 +254,21 @@ void EsLocale::checkLocalisationLoaded()
 					std::string	msgstr = line.substr(start + 1, end - start - 1);
 					if (!msgid.empty() && !msgstr.empty())
 						if (idx.empty() || idx == "0")
-							mItems[msgid] = msgstr;
+							catalogue->items[msgid] = msgstr;
 
 					if (!msgid_plural.empty() && !msgstr.empty())
 					{
 						if (!idx.empty() && idx != "0")
-							mItems[idx + "@" + msgid_plural] = msgstr;
+							catalogue->items[idx + "@" + msgid_plural] = msgstr;
 						else
-							mItems[msgid_plural] = msgstr;
+							catalogue->items[msgid_plural] = msgstr;
 					}
 				}
 			}
 		}
 	}
+
+	return catalogue;
 }
 
 
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <string>
 #include <map>
+#include <unordered_map>
 #include <functional>
 #include "utils/StringUtil.h"
 
@@ -15,20 +18,46 @@ struct PluralRule
 class EsLocale
 {
 public:
-	static const std::string getText(const std::string text);
-	static const std::string nGetText(const std::string msgid, const std::string msgid_plural, int n);
+	static const std::string getText(const std::string& text);
+	static const std::string nGetText(const std::string& msgid, const std::string& msgid_plural, int n);
 
-	static const std::string getLanguage() { return mCurrentLanguage; }
+	struct LiteralTranslation
+	{
+		int generation; // of the catalogue it was found in
+		std::string msgid;
+		std::string text;
+	};
+
+	// _("literal") : each call site remembers the translation for the current language, later calls don't hash the text.
+	// The translation is a copy : it stays valid when another language is loaded.
+	struct LiteralCache
+	{
+		std::shared_ptr<const LiteralTranslation> translation; // read and replaced with std::atomic_load / std::atomic_store
+	};
+
+	// Only const arrays are cached : a char buffer filled at runtime goes through the lookup every time
+	template<size_t N>
+	static const std::string getText(const char (&text)[N], LiteralCache* cache) { return getTextFromLiteral(text, cache); }
+	template<size_t N>
+	static const std::string getText(char (&text)[N], LiteralCache* /*cache*/) { return getText(std::string(text)); }
+	static const std::string getText(const std::string& text, LiteralCache* /*cache*/) { return getText(text); }
+
+	// Same result as getText(text), the cache is checked against the text before it is used
+	static const std::string getTextFromLiteral(const char* text, LiteralCache* cache);
+
+	static const std::string getLanguage();
 
 	static const void reset() { mCurrentLanguageLoaded = false; }
 
 private:
-	static void checkLocalisationLoaded();
-	static std::map<std::string, std::string> mItems;
-	static std::string mCurrentLanguage;
-	static bool mCurrentLanguageLoaded;
+	struct Catalogue;
+
+	static std::shared_ptr<const Catalogue> getCatalogue();
+	static std::shared_ptr<const Catalogue> loadCatalogue(const std::string& language, int generation);
 
-	static PluralRule mPluralRule;
+	// Replaced as a whole when a language is loaded, read with std::atomic_load : a lookup keeps its snapshot alive
+	static std::shared_ptr<const Catalogue> mCatalogue;
+	static std::atomic<bool> mCurrentLanguageLoaded;
 };
 
 
@@ -37,13 +66,13 @@ private:
 	#define _L(x) L ## x
 	#define _U(x) Utils::String::convertFromWideString(L ## x)
 	
-	#define _(x) EsLocale::getText(x)
+	#define _(x) EsLocale::getText(x, []() { static EsLocale::LiteralCache cache; return &cache; }())
 #else
 
 	#define UNICODE_CHARTYPE char*
 	#define _L(x) x
 	#define _U(x) x
 
-	#define _(x) EsLocale::getText(x)
+	#define _(x) EsLocale::getText(x, []() { static EsLocale::LiteralCache cache; return &cache; }())
 #endif // _WIN32
 
@@ -13,7 +13,8 @@ bool GuiComponent::ALLOWANIMATIONS = true;
 
 GuiComponent::GuiComponent(Window* window) : mWindow(window), mParent(NULL), mOpacity(255),
 	mPosition(Vector3f::Zero()), mOrigin(Vector2f::Zero()), mRotationOrigin(0.5, 0.5),
-	mSize(Vector2f::Zero()), mTransform(Transform4x4f::Identity()), mIsProcessing(false), mVisible(true)
+	mSize(Vector2f::Zero()), mTransform(Transform4x4f::Identity()), mIsProcessing(false), mVisible(true), mCullable(false),
+	mTransformDirty(true), mTransformSize(Vector2f::Zero()), mTransformScale(1.0, 1.0, 1.0), mTransformRotationSize(Vector2f::Zero())
 {
 	for(unsigned char i = 0; i < MAX_ANIMATIONS; i++)
 		mAnimationMap[i] = NULL;
@@ -63,6 +64,19 @@ void GuiComponent::update(int deltaTime)
 	updateChildren(deltaTime);
 }
 
+bool GuiComponent::isAnimating()
+{
+	for(unsigned char i = 0; i < MAX_ANIMATIONS; i++)
+		if(mAnimationMap[i] != NULL)
+			return true;
+
+	for(unsigned int i = 0; i < getChildCount(); i++)
+		if(getChild(i)->isVisible() && getChild(i)->isAnimating())
+			return true;
+
+	return false;
+}
+
 void GuiComponent::render(const Transform4x4f& parentTrans)
 {
 	if (!isVisible())
@@ -76,10 +90,32 @@ void GuiComponent::renderChildren(const Transform4x4f& transform) const
 {
 	for(unsigned int i = 0; i < getChildCount(); i++)
 	{
-		getChild(i)->render(transform);
+		GuiComponent* child = getChild(i);
+		if(!child->mVisible || (child->mCullable && child->isOffScreen(transform)))
+			continue;
+
+		child->render(transform);
 	}
 }
 
+bool GuiComponent::isOffScreen(const Transform4x4f& parentTrans)
+{
+	if(mRotation != 0.0 || mSize.x() <= 0 || mSize.y() <= 0)
+		return false;
+
+	Transform4x4f trans = parentTrans * getTransform();
+
+	// only axis aligned boxes can be tested
+	if(trans.r0().y() != 0 || trans.r1().x() != 0)
+		return false;
+
+	Vector3f dim = trans * Vector3f(mSize.x(), mSize.y(), 0) - trans.translation();
+	if(dim.x() < 0 || dim.y() < 0)
+		return false;
+
+	return !Renderer::isVisibleOnScreen(trans.translation().x(), trans.translation().y(), dim.x(), dim.y());
+}
+
 Vector3f GuiComponent::getPosition() const
 {
 	return mPosition;
@@ -88,6 +124,7 @@ Vector3f GuiComponent::getPosition() const
 void GuiComponent::setPosition(float x, float y, float z)
 {
 	mPosition = Vector3f(x, y, z);
+	mTransformDirty = true;
 	onPositionChanged();
 }
 
@@ -99,6 +136,7 @@ Vector2f GuiComponent::getOrigin() const
 void GuiComponent::setOrigin(float x, float y)
 {
 	mOrigin = Vector2f(x, y);
+	mTransformDirty = true;
 	onOriginChanged();
 }
 
@@ -110,6 +148,7 @@ Vector2f GuiComponent::getRotationOrigin() const
 void GuiComponent::setRotationOrigin(float x, float y)
 {
 	mRotationOrigin = Vector2f(x, y);
+	mTransformDirty = true;
 }
 
 Vector2f GuiComponent::getSize() const
@@ -131,6 +170,7 @@ float GuiComponent::getRotation() const
 void GuiComponent::setRotation(float rotation)
 {
 	mRotation = rotation;
+	mTransformDirty = true;
 }
 
 Vector3f GuiComponent::getScale() const
@@ -268,6 +308,14 @@ void GuiComponent::setOpacity(unsigned char opacity)
 
 const Transform4x4f& GuiComponent::getTransform()
 {
+	// mSize and mScale are also written directly by some components, compare them instead of relying on the dirty flag
+	if(!mTransformDirty && mTransformSize == mSize && mTransformScale == mScale && (mRotation == 0.0 || mTransformRotationSize == getRotationSize()))
+		return mTransform;
+
+	mTransformDirty = false;
+	mTransformSize = mSize;
+	mTransformScale = mScale;
+
 	mTransform = Transform4x4f::Identity();
 	mTransform.translate(mPosition);
 	if (mScale != 1.0)
@@ -278,6 +326,7 @@ const Transform4x4f& GuiComponent::getTransform()
 	{
 		// Calculate offset as difference between origin and rotation origin
 		Vector2f rotationSize = getRotationSize();
+		mTransformRotationSize = rotationSize;
 		float xOff = (mOrigin.x() - mRotationOrigin.x()) * rotationSize.x();
 		float yOff = (mOrigin.y() - mRotationOrigin.y()) * rotationSize.y();
 
@@ -433,34 +482,43 @@ void GuiComponent::applyTheme(const std::shared_ptr<ThemeData>& theme, const std
 	if(!elem)
 		return;
 
+	// applied to every themed component : the property names are resolved once
+	static const int posId = ThemeData::ThemeElement::getPropertyId("pos");
+	static const int sizeId = ThemeData::ThemeElement::getPropertyId("size");
+	static const int originId = ThemeData::ThemeElement::getPropertyId("origin");
+	static const int rotationId = ThemeData::ThemeElement::getPropertyId("rotation");
+	static const int rotationOriginId = ThemeData::ThemeElement::getPropertyId("rotationOrigin");
+	static const int zIndexId = ThemeData::ThemeElement::getPropertyId("zIndex");
+	static const int visibleId = ThemeData::ThemeElement::getPropertyId("visible");
+
 	using namespace ThemeFlags;
-	if(properties & POSITION && elem->has("pos"))
+	if(properties & POSITION && elem->has(posId))
 	{
-		Vector2f denormalized = elem->get<Vector2f>("pos") * scale;
+		Vector2f denormalized = elem->get<Vector2f>(posId) * scale;
 		setPosition(Vector3f(denormalized.x(), denormalized.y(), 0));
 	}
 
-	if(properties & ThemeFlags::SIZE && elem->has("size"))
-		setSize(elem->get<Vector2f>("size") * scale);
+	if(properties & ThemeFlags::SIZE && elem->has(sizeId))
+		setSize(elem->get<Vector2f>(sizeId) * scale);
 
 	// position + size also implies origin
-	if((properties & ORIGIN || (properties & POSITION && properties & ThemeFlags::SIZE)) && elem->has("origin"))
-		setOrigin(elem->get<Vector2f>("origin"));
+	if((properties & ORIGIN || (properties & POSITION && properties & ThemeFlags::SIZE)) && elem->has(originId))
+		setOrigin(elem->get<Vector2f>(originId));
 
 	if(properties & ThemeFlags::ROTATION) {
-		if(elem->has("rotation"))
-			setRotationDegrees(elem->get<float>("rotation"));
-		if(elem->has("rotationOrigin"))
-			setRotationOrigin(elem->get<Vector2f>("rotationOrigin"));
+		if(elem->has(rotationId))
+			setRotationDegrees(elem->get<float>(rotationId));
+		if(elem->has(rotationOriginId))
+			setRotationOrigin(elem->get<Vector2f>(rotationOriginId));
 	}
 
-	if(properties & ThemeFlags::Z_INDEX && elem->has("zIndex"))
-		setZIndex(elem->get<float>("zIndex"));
+	if(properties & ThemeFlags::Z_INDEX && elem->has(zIndexId))
+		setZIndex(elem->get<float>(zIndexId));
 	else
 		setZIndex(getDefaultZIndex());
 
-	if(properties & ThemeFlags::VISIBLE && elem->has("visible"))
-		setVisible(elem->get<bool>("visible"));
+	if(properties & ThemeFlags::VISIBLE && elem->has(visibleId))
+		setVisible(elem->get<bool>(visibleId));
 	else
 		setVisible(true);
 }
@@ -57,6 +57,10 @@ public:
 	//4. Tell your children to render, based on your component's transform - renderChildren(t).
 	virtual void render(const Transform4x4f& parentTrans);
 
+	//Returns true if what the component renders may change between two frames ( animation, video, scrolling... ). Called after update.
+	//Default implementation checks the animations of the component and of its visible children. Static frames are not rendered again.
+	virtual bool isAnimating();
+
 	Vector3f getPosition() const;
 	inline void setPosition(const Vector3f& offset) { setPosition(offset.x(), offset.y(), offset.z()); }
 	void setPosition(float x, float y, float z = 0.0f);
@@ -129,6 +133,10 @@ public:
 
 	const Transform4x4f& getTransform();
 
+	// Returns true if the component, rendered with parentTrans, lies entirely outside the screen or the current clip rect.
+	// Rotated components are never considered off screen.
+	bool isOffScreen(const Transform4x4f& parentTrans);
+
 	virtual std::string getValue() const;
 	virtual void setValue(const std::string& value);
 
@@ -190,12 +198,17 @@ protected:
 
 	bool mIsProcessing;
 	bool mVisible;
+	bool mCullable; // everything this component draws stays inside its bounds, renderChildren can skip it when it's off screen
 
 public:
 	const static unsigned char MAX_ANIMATIONS = 4;
 
 private:
 	Transform4x4f mTransform; //Don't access this directly! Use getTransform()!
+	bool mTransformDirty;
+	Vector2f mTransformSize;
+	Vector3f mTransformScale;
+	Vector2f mTransformRotationSize;
 	AnimationController* mAnimationMap[MAX_ANIMATIONS];
 };
 
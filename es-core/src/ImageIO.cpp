@@ -10,6 +10,92 @@
 #include "utils/FileSystemUtil.h"
 #include "utils/StringUtil.h"
 
+// SSE2 is always there on x86-64, NEON must be enabled by the toolchain (aarch64, or -mfpu=neon on armv7)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define IMAGEIO_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define IMAGEIO_NEON
+#include <arm_neon.h>
+#endif
+
+// Converts FreeImage BGRA pixels to RGBA
+static void swizzleBGRAToRGBA(const unsigned int* src, unsigned int* dst, int count)
+{
+	int x = 0;
+
+#if defined(IMAGEIO_SSE2)
+	const __m128i ag = _mm_set1_epi32(0xFF00FF00);
+	const __m128i b = _mm_set1_epi32(0x000000FF);
+
+	for (; x + 4 <= count; x += 4)
+	{
+		__m128i c = _mm_loadu_si128((const __m128i*)(src + x));
+		__m128i r = _mm_or_si128(_mm_and_si128(c, ag), _mm_or_si128(_mm_slli_epi32(_mm_and_si128(c, b), 16), _mm_and_si128(_mm_srli_epi32(c, 16), b)));
+		_mm_storeu_si128((__m128i*)(dst + x), r);
+	}
+#elif defined(IMAGEIO_NEON)
+	for (; x + 16 <= count; x += 16)
+	{
+		uint8x16x4_t c = vld4q_u8((const uint8_t*)(src + x));
+		uint8x16_t tmp = c.val[0];
+		c.val[0] = c.val[2];
+		c.val[2] = tmp;
+		vst4q_u8((uint8_t*)(dst + x), c);
+	}
+#endif
+
+	for (; x < count; x++)
+	{
+		unsigned int c = src[x];
+		dst[x] = (c & 0xFF00FF00) | ((c & 0xFF) << 16) | ((c >> 16) & 0xFF);
+	}
+}
+
+// Reads the frame size of a JPEG held in memory
+static bool getJpegSizeFromMemory(const unsigned char* data, size_t size, unsigned int* x, unsigned int* y)
+{
+	if (size < 4 || data[0] != 0xFF || data[1] != 0xD8)
+		return false;
+
+	size_t pos = 2;
+	while (pos + 9 < size)
+	{
+		if (data[pos] != 0xFF)
+			return false;
+
+		unsigned char marker = data[pos + 1];
+		if (marker == 0xFF) // fill byte
+		{
+			pos++;
+			continue;
+		}
+
+		// SOFn frames, DHT (C4), JPG (C8) and DAC (CC) share the range but are not frames
+		if (marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC)
+		{
+			*y = (data[pos + 5] << 8) + data[pos + 6];
+			*x = (data[pos + 7] << 8) + data[pos + 8];
+			return *x > 0 && *y > 0;
+		}
+
+		// Start of scan without any frame before : give up
+		if (marker == 0xDA)
+			return false;
+
+		// Standalone markers
+		if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD7))
+		{
+			pos += 2;
+			continue;
+		}
+
+		pos += 2 + (data[pos + 2] << 8) + data[pos + 3];
+	}
+
+	return false;
+}
+
 bool ImageIO::getImageSize(const char *fn, unsigned int *x, unsigned int *y)
 {
 	LOG(LogDebug) << "ImageIO::loadImageSize " << fn;
@@ -139,32 +225,14 @@ std::vector<unsigned char> ImageIO::loadFromMemoryRGBA32(const unsigned char * d
 					//loop through scanlines and add all pixel data to the return vector
 					//this is necessary, because width*height*bpp might not be == pitch
 
-					unsigned char * tempData = new unsigned char[width * height * 4];
 					unsigned char * bytes = FreeImage_GetBits(fiBitmap);
 
-				//	memcpy(tempData, bytes, width * height * 4);
-/*
-					for (size_t i = 0; i < height; i++)
-					{
-						const BYTE * scanLine = FreeImage_GetScanLine(fiBitmap, (int)i);
-						memcpy(tempData + (i * width * 4), scanLine, width * 4);
-					}*/
 					//convert from BGRA to RGBA
-					for(size_t i = 0; i < width*height; i++)
-					{
-						RGBQUAD bgra = ((RGBQUAD *)bytes)[i];
-						RGBQUAD rgba;
-						rgba.rgbBlue = bgra.rgbRed;
-						rgba.rgbGreen = bgra.rgbGreen;
-						rgba.rgbRed = bgra.rgbBlue;
-						rgba.rgbReserved = bgra.rgbReserved;
-						((RGBQUAD *)tempData)[i] = rgba;
-					}
-					
-					rawData = std::vector<unsigned char>(tempData, tempData + width * height * 4);
+					rawData.resize(width * height * 4);
+					swizzleBGRAToRGBA((const unsigned int*)bytes, (unsigned int*)rawData.data(), (int)(width * height));
+
 					//free bitmap data
 					FreeImage_Unload(fiBitmap);
-					delete[] tempData;
 				}
 			}
 			else
@@ -252,8 +320,23 @@ unsigned char* ImageIO::loadFromMemoryRGBA32Ex(const unsigned char * data, const
 		FREE_IMAGE_FORMAT format = FreeImage_GetFileTypeFromMemory(fiMemory);
 		if (format != FIF_UNKNOWN && FreeImage_FIFSupportsReading(format))
 		{
+			int flags = 0;
+
+			// JPEG : libjpeg can decode directly at 1/2, 1/4 or 1/8 of the size in the DCT domain.
+			// FreeImage picks the smallest of these scales that stays larger than the size requested in the upper 16 bits
+			unsigned int jpegWidth = 0;
+			unsigned int jpegHeight = 0;
+
+			if (format == FIF_JPEG && maxWidth > 0 && maxHeight > 0 && getJpegSizeFromMemory(data, size, &jpegWidth, &jpegHeight) && ((int)jpegWidth > maxWidth || (int)jpegHeight > maxHeight))
+			{
+				Vector2i sz = adjustPictureSize(Vector2i(jpegWidth, jpegHeight), Vector2i(maxWidth, maxHeight), externZoom);
+				int requestedSize = jpegWidth > jpegHeight ? sz.x() : sz.y();
+				if (requestedSize > 0 && requestedSize < 0xFFFF)
+					flags = JPEG_DEFAULT | (requestedSize << 16);
+			}
+
 			//file type is supported. load image
-			FIBITMAP * fiBitmap = FreeImage_LoadFromMemory(format, fiMemory);
+			FIBITMAP * fiBitmap = FreeImage_LoadFromMemory(format, fiMemory, flags);
 			if (fiBitmap != nullptr)
 			{
 				//loaded. convert to 32bit if necessary
@@ -273,11 +356,15 @@ unsigned char* ImageIO::loadFromMemoryRGBA32Ex(const unsigned char * data, const
 					width = FreeImage_GetWidth(fiBitmap);
 					height = FreeImage_GetHeight(fiBitmap);
 
-					baseSize = Vector2i(width, height);
+					// A JPEG decoded at a reduced scale still reports its real size
+					if (flags != 0)
+						baseSize = Vector2i(jpegWidth, jpegHeight);
+					else
+						baseSize = Vector2i(width, height);
 					
-					if (maxWidth > 0 && maxHeight > 0 && (width > maxWidth || height > maxHeight))
+					if (maxWidth > 0 && maxHeight > 0 && (baseSize.x() > maxWidth || baseSize.y() > maxHeight))
 					{
-						Vector2i sz = adjustPictureSize(Vector2i(width, height), Vector2i(maxWidth, maxHeight), externZoom);
+						Vector2i sz = adjustPictureSize(baseSize, Vector2i(maxWidth, maxHeight), externZoom);
 						if (sz.x() != width || sz.y() != height)
 						{							
 							FIBITMAP* imageRescaled = FreeImage_Rescale(fiBitmap, sz.x(), sz.y(), FILTER_BOX);
@@ -286,9 +373,10 @@ unsigned char* ImageIO::loadFromMemoryRGBA32Ex(const unsigned char * data, const
 
 							width = FreeImage_GetWidth(fiBitmap);
 							height = FreeImage_GetHeight(fiBitmap);
-							
-							packedSize = Vector2i(width, height);
 						}
+
+						if (width != baseSize.x() || height != baseSize.y())
+							packedSize = Vector2i(width, height);
 					}
 					
 					//loop through scanlines and add all pixel data to the return vector
@@ -296,18 +384,8 @@ unsigned char* ImageIO::loadFromMemoryRGBA32Ex(const unsigned char * data, const
 
 					unsigned char* tempData = new unsigned char[width * height * 4];
 
-					int w = (int)width;
-
 					for (int y = (int)height; --y >= 0; )
-					{
-						unsigned int* argb = (unsigned int*)FreeImage_GetScanLine(fiBitmap, y);
-						unsigned int* abgr = (unsigned int*)(tempData + (y * width * 4));
-						for (int x = w; --x >= 0;)
-						{
-							unsigned int c = argb[x];
-							abgr[x] = (c & 0xFF00FF00) | ((c & 0xFF) << 16) | ((c >> 16) & 0xFF);
-						}
-					}
+						swizzleBGRAToRGBA((const unsigned int*)FreeImage_GetScanLine(fiBitmap, y), (unsigned int*)(tempData + (y * width * 4)), (int)width);
 				
 					FreeImage_Unload(fiBitmap);
 					FreeImage_CloseMemory(fiMemory);
@@ -0,0 +1,144 @@
+#include "InputScript.h"
+
+#include "renderers/Renderer.h"
+#include "utils/StringUtil.h"
+#include "InputManager.h"
+#include "Log.h"
+#include "Window.h"
+#include <SDL_timer.h>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+InputScript::InputScript() : mCurrent(0), mRemaining(-1), mPressed(false), mFailed(false), mFrames(0), mStartTime(0)
+{
+}
+
+bool InputScript::load(const std::string& path)
+{
+	std::ifstream file(path);
+	if (!file.is_open())
+	{
+		LOG(LogError) << "Unable to open input script \"" << path << "\"";
+		return false;
+	}
+
+	std::string line;
+	while (std::getline(file, line))
+	{
+		line = Utils::String::trim(line);
+		if (line.empty() || line[0] == '#')
+			continue;
+
+		auto splits = Utils::String::split(line, ' ');
+
+		Command command;
+		command.action = Utils::String::toLower(splits[0]);
+		command.count = splits.size() > 1 ? atoi(splits[1].c_str()) : 1;
+		mCommands.push_back(command);
+	}
+
+	LOG(LogInfo) << "Input script \"" << path << "\" loaded, " << mCommands.size() << " commands";
+	return true;
+}
+
+bool InputScript::resolveInput(const std::string& action, InputConfig** config, Input* input)
+{
+	*config = InputManager::getInstance()->getInputConfigByDevice(DEVICE_KEYBOARD);
+	if (*config != nullptr && (*config)->getInputByName(action, input))
+		return true;
+
+	LOG(LogError) << "Input script : unknown input \"" << action << "\", the script is aborted";
+	mFailed = true;
+	return false;
+}
+
+bool InputScript::update(Window* window)
+{
+	if (mFrames == 0)
+	{
+		// Check every input before playing anything, a script that skips steps would measure something else
+		for (const auto& command : mCommands)
+		{
+			if (command.action == "wait" || command.action == "quit")
+				continue;
+
+			InputConfig* config;
+			Input input;
+			if (!resolveInput(command.action, &config, &input))
+				return false;
+		}
+
+		mStartTime = SDL_GetTicks();
+#if defined(USE_NULL_RENDERER)
+		Renderer::resetStatistics();
+#endif
+	}
+
+	mFrames++;
+
+	while (mCurrent < mCommands.size())
+	{
+		const Command& command = mCommands[mCurrent];
+		if (command.action == "quit")
+			break;
+
+		if (mRemaining < 0)
+			mRemaining = command.count;
+
+		if (mRemaining == 0)
+		{
+			mCurrent++;
+			mRemaining = -1;
+			continue;
+		}
+
+		if (command.action == "wait")
+		{
+			mRemaining--;
+			return true;
+		}
+
+		InputConfig* config;
+		Input input;
+		if (!resolveInput(command.action, &config, &input))
+			return false;
+
+		// a press takes one frame, the release the next one
+		input.value = mPressed ? 0 : 1;
+		window->input(config, input);
+
+		mPressed = !mPressed;
+		if (!mPressed)
+			mRemaining--;
+
+		return true;
+	}
+
+	logResults();
+	return false;
+}
+
+void InputScript::logResults()
+{
+	unsigned int duration = SDL_GetTicks() - mStartTime;
+
+	std::stringstream ss;
+	ss << "Input script ended : " << mFrames << " frames in " << duration << "ms";
+
+	if (mFrames > 0)
+		ss << " (" << ((float)duration / (float)mFrames) << "ms/frame)";
+
+#if defined(USE_NULL_RENDERER)
+	const Renderer::Statistics& statistics = Renderer::getStatistics();
+	unsigned int frames = statistics.frames > 0 ? statistics.frames : 1;
+
+	ss << ", draw calls : " << statistics.drawCalls << " (" << (statistics.drawCalls / frames) << "/frame)";
+	ss << ", vertices : " << statistics.vertices << " (" << (statistics.vertices / frames) << "/frame)";
+	ss << ", texture uploads : " << statistics.textureUploads << " (" << (statistics.textureBytes / 1024) << "KB)";
+	ss << ", live textures : " << statistics.textures;
+#endif
+
+	LOG(LogInfo) << ss.str();
+	std::cout << ss.str() << "\n";
+}
@@ -0,0 +1,53 @@
+#pragma once
+#ifndef ES_CORE_INPUT_SCRIPT_H
+#define ES_CORE_INPUT_SCRIPT_H
+
+#include "InputConfig.h"
+#include <string>
+#include <vector>
+
+class Window;
+
+// Plays a scripted sequence of keyboard inputs, one step per frame, for repeatable UI benchmarks.
+// One command per line, '#' starts a comment :
+//   down 20     press & release "down" 20 times
+//   wait 60     render 60 frames without input
+//   quit        stop the script ( also stops at the end of the file )
+// An input missing from the keyboard configuration fails the script, the program then exits with a non-zero code.
+class InputScript
+{
+public:
+	InputScript();
+
+	bool load(const std::string& path);
+
+	// Plays the next frame of the script. Returns false when the script has ended
+	bool update(Window* window);
+
+	// The script used an input that doesn't exist in the keyboard configuration : it didn't play what it describes
+	bool hasFailed() const { return mFailed; }
+
+	// Frame duration to use while a script is running, so that animations are the same on every run
+	static int getFrameTime() { return 16; }
+
+private:
+	struct Command
+	{
+		std::string action;
+		int count;
+	};
+
+	bool resolveInput(const std::string& action, InputConfig** config, Input* input);
+	void logResults();
+
+	std::vector<Command> mCommands;
+	size_t mCurrent;
+	int mRemaining;
+	bool mPressed;
+	bool mFailed;
+
+	unsigned int mFrames;
+	unsigned int mStartTime;
+};
+
+#endif // ES_CORE_INPUT_SCRIPT_H
@@ -2,8 +2,11 @@
 
 #include "utils/FileSystemUtil.h"
 #include "platform.h"
+#include <atomic>
+#include <chrono>
 #include <iostream>
 #include <mutex>
+#include <thread>
 #include "Settings.h"
 
 #if WIN32
@@ -12,10 +15,96 @@
 
 static std::mutex mLogLock;
 
+// Messages are queued by the logging threads and written to the file by a background writer.
+// The queue is a bounded multi-producer ring (D. Vyukov) : each slot carries a sequence number telling
+// whether it's free for the producer at that position, or holds a message ready for the consumer
+#define LOG_QUEUE_SIZE 8192 // must be a power of two
+#define LOG_WRITER_INTERVAL 10 // ms
+
+struct LogRecord
+{
+	std::atomic<size_t> sequence;
+	std::string text;
+};
+
+static LogRecord sLogQueue[LOG_QUEUE_SIZE];
+static std::atomic<size_t> sLogEnqueuePos(0);
+static size_t sLogDequeuePos = 0;
+
+static std::mutex sLogWriterLock; // consumer side : the writer thread or Log::flush
+static FILE* sLogFile = NULL; // the file the consumer writes to, guarded by sLogWriterLock
+static std::thread sLogWriterThread;
+static std::atomic<bool> sLogWriterRunning(false);
+
 LogLevel Log::reportingLevel = LogInfo;
-bool Log::dirty = false;
 FILE* Log::file = NULL;
 
+// Writes the queued messages to the file
+static void drainLogQueue()
+{
+	std::unique_lock<std::mutex> lock(sLogWriterLock);
+
+	bool written = false;
+
+	while (true)
+	{
+		LogRecord& record = sLogQueue[sLogDequeuePos & (LOG_QUEUE_SIZE - 1)];
+		if (record.sequence.load(std::memory_order_acquire) != sLogDequeuePos + 1)
+			break; // empty, or the producer didn't finish to write it yet
+
+		if (sLogFile != NULL)
+			fputs(record.text.c_str(), sLogFile);
+
+		record.text.clear();
+		record.sequence.store(sLogDequeuePos + LOG_QUEUE_SIZE, std::memory_order_release);
+		sLogDequeuePos++;
+
+		written = true;
+	}
+
+	if (written && sLogFile != NULL)
+		fflush(sLogFile);
+}
+
+static void queueLogMessage(std::string& text)
+{
+	size_t pos = sLogEnqueuePos.load(std::memory_order_relaxed);
+	LogRecord* record;
+
+	while (true)
+	{
+		record = &sLogQueue[pos & (LOG_QUEUE_SIZE - 1)];
+		
+		size_t sequence = record->sequence.load(std::memory_order_acquire);
+		if (sequence == pos)
+		{
+			if (sLogEnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				break;
+		}
+		else if ((long long)sequence - (long long)pos < 0)
+		{
+			// Full : don't wait for the writer
+			drainLogQueue();
+			std::this_thread::yield();
+			pos = sLogEnqueuePos.load(std::memory_order_relaxed);
+		}
+		else
+			pos = sLogEnqueuePos.load(std::memory_order_relaxed);
+	}
+
+	record->text.swap(text);
+	record->sequence.store(pos + 1, std::memory_order_release);
+}
+
+static void logWriterThreadProc()
+{
+	while (sLogWriterRunning)
+	{
+		drainLogQueue();
+		std::this_thread::sleep_for(std::chrono::milliseconds(LOG_WRITER_INTERVAL));
+	}
+}
+
 LogLevel Log::getReportingLevel()
 {
 	return reportingLevel;
@@ -36,22 +125,58 @@ void Log::init()
 {
 	std::unique_lock<std::mutex> lock(mLogLock);
 
-	if (file != NULL)
-		close();
+	// The ring is set up once, before any message is queued : init is called again when the log level changes,
+	// while other threads may hold a claimed position
+	static bool queueReady = false;
+	if (!queueReady)
+	{
+		for (size_t i = 0; i < LOG_QUEUE_SIZE; i++)
+			sLogQueue[i].sequence.store(i, std::memory_order_relaxed);
+
+		queueReady = true;
+	}
 
 	if (Settings::getInstance()->getString("LogLevel") == "disabled")
 	{
+		close();
 		remove(getLogPath().c_str());
 		return;
 	}
 
+	// The writer keeps running, only the file it writes to is replaced. What's queued goes to the previous file
+	if (file != NULL)
+	{
+		drainLogQueue();
+
+		std::unique_lock<std::mutex> writerLock(sLogWriterLock);
+		fclose(sLogFile);
+		sLogFile = NULL;
+	}
+
 	remove((getLogPath() + ".bak").c_str());
 
 	// rename previous log file
 	rename(getLogPath().c_str(), (getLogPath() + ".bak").c_str());
 
-	file = fopen(getLogPath().c_str(), "w");
-	dirty = false;
+	FILE* newFile = fopen(getLogPath().c_str(), "w");
+	if (newFile == NULL)
+	{
+		close();
+		return;
+	}
+
+	{
+		std::unique_lock<std::mutex> writerLock(sLogWriterLock);
+		sLogFile = newFile;
+	}
+
+	file = newFile;
+
+	if (!sLogWriterRunning)
+	{
+		sLogWriterRunning = true;
+		sLogWriterThread = std::thread(logWriterThreadProc);
+	}
 }
 
 std::ostringstream& Log::get(LogLevel level)
@@ -77,50 +202,54 @@ std::ostringstream& Log::get(LogLevel level)
 	return os;
 }
 
+// Writes what's queued right now, on the calling thread. The writer thread does it anyway every few ms
 void Log::flush()
 {
-	if (!dirty)
-		return;
-
-	if (file != nullptr)
-		fflush(file);
-
-	dirty = false;
+	if (file != NULL)
+		drainLogQueue();
 }
 
 void Log::close()
 {
-	if (file != NULL)
+	if (sLogWriterRunning)
 	{
-		fflush(file);
-		fclose(file);
+		sLogWriterRunning = false;
+
+		if (sLogWriterThread.joinable())
+			sLogWriterThread.join();
 	}
 
-	dirty = false;
 	file = NULL;
+
+	drainLogQueue();
+
+	std::unique_lock<std::mutex> writerLock(sLogWriterLock);
+	if (sLogFile != NULL)
+	{
+		fclose(sLogFile);
+		sLogFile = NULL;
+	}
 }
 
 Log::~Log()
 {
-	std::unique_lock<std::mutex> lock(mLogLock);
+	os << '\n';
 
-	if (file != NULL)
-	{
-		os << std::endl;
-		fprintf(file, "%s", os.str().c_str());
-		dirty = true;
-	}
+	std::string text = os.str();
 
 	// If it's an error, also print to console
 	// print all messages if using --debug
 	if (messageLevel == LogError || reportingLevel >= LogDebug)
 	{
 #if WIN32
-		OutputDebugStringA(os.str().c_str());
+		OutputDebugStringA(text.c_str());
 #else
-		fprintf(stderr, "%s", os.str().c_str());
+		fprintf(stderr, "%s", text.c_str());
 #endif
 	}
+
+	if (file != NULL)
+		queueLogMessage(text);
 }
 
 void Log::setupReportingLevel()
@@ -5,7 +5,12 @@
 #include <sstream>
 #include <exception>
 
-#define LOG(level) if(!Log::Enabled() || level > Log::getReportingLevel()) ; else Log().get(level)
+// Messages above ES_LOG_MAX_LEVEL are compiled out, define it to LogWarning or LogError in release builds to build no string at all
+#ifndef ES_LOG_MAX_LEVEL
+#define ES_LOG_MAX_LEVEL LogDebug
+#endif
+
+#define LOG(level) if(level > ES_LOG_MAX_LEVEL || !Log::Enabled() || level > Log::getReportingLevel()) ; else Log().get(level)
 
 #define TRYCATCH(m, x) try { x; } \
 catch (const std::exception& e) { LOG(LogError) << m << " Exception " << e.what(); Log::flush(); throw e; } \
@@ -38,7 +43,6 @@ protected:
 
 private:
 	static LogLevel reportingLevel;
-	static bool dirty;
 
 	LogLevel messageLevel;
 };
@@ -4,8 +4,43 @@
 #include "utils/FileSystemUtil.h"
 #include "Log.h"
 #include <pugixml/src/pugixml.hpp>
+#include <algorithm>
 #include <string.h>
 
+#if !WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// The three XML files are compiled into a binary database in the home folder, which is mapped in memory on the next
+// boots without any parsing. It is rebuilt when the size or date of one of the XML files changes.
+//
+// Layout : header, name pairs (offsets of the mame name & real name), bioses & devices (offsets), string table.
+// Each list is sorted with strcmp so lookups are binary searches, all offsets are from the start of the file.
+#define MAMENAMES_DB_MAGIC   0x4E4D5345 // "ESMN"
+#define MAMENAMES_DB_VERSION 1
+
+struct MameNamesHeader
+{
+	unsigned int magic;
+	unsigned int version;
+	long long    sourceSize[3];
+	long long    sourceDate[3];
+	unsigned int nameCount;
+	unsigned int biosCount;
+	unsigned int deviceCount;
+	unsigned int dataSize;
+};
+
+static const char* sSourceFiles[3] = { ":/mamenames.xml", ":/mamebioses.xml", ":/mamedevices.xml" };
+
+static std::string getDatabasePath()
+{
+	return Utils::FileSystem::getHomePath() + "/.emulationstation/mamenames.db";
+}
+
 MameNames* MameNames::sInstance = nullptr;
 
 void MameNames::init()
@@ -34,106 +69,316 @@ MameNames* MameNames::getInstance()
 
 } // getInstance
 
-MameNames::MameNames()
+MameNames::MameNames() : mData(nullptr), mDataSize(0), mMapped(false)
 {
-	std::string xmlpath = ResourceManager::getInstance()->getResourcePath(":/mamenames.xml");
+	MameNamesHeader header;
+	memset(&header, 0, sizeof(header));
 
-	if(!Utils::FileSystem::exists(xmlpath))
+	header.magic = MAMENAMES_DB_MAGIC;
+	header.version = MAMENAMES_DB_VERSION;
+
+	for (int i = 0; i < 3; i++)
+	{
+		std::string xmlpath = ResourceManager::getInstance()->getResourcePath(sSourceFiles[i]);
+		if (Utils::FileSystem::exists(xmlpath))
+		{
+			header.sourceSize[i] = (long long)Utils::FileSystem::getFileSize(xmlpath);
+			header.sourceDate[i] = (long long)Utils::FileSystem::getFileModificationDate(xmlpath);
+		}
+		else if (ResourceManager::getInstance()->fileExists(sSourceFiles[i]))
+		{
+			// packed in the resource archive : there's no file date, the size identifies the version
+			header.sourceSize[i] = (long long)ResourceManager::getInstance()->getFileData(sSourceFiles[i]).length;
+			header.sourceDate[i] = 0;
+		}
+		else
+			header.sourceSize[i] = -1;
+	}
+
+	if (loadDatabase(header))
 		return;
 
-	LOG(LogInfo) << "Parsing XML file \"" << xmlpath << "\"...";
+	buildDatabase(header);
 
-	pugi::xml_document doc;
-	pugi::xml_parse_result result = doc.load_file(xmlpath.c_str());
+} // MameNames
+
+MameNames::~MameNames()
+{
+#if !WIN32
+	if (mMapped)
+		munmap((void*)mData, mDataSize);
+#endif
+
+} // ~MameNames
+
+bool MameNames::loadDatabase(const MameNamesHeader& sources)
+{
+	std::string path = getDatabasePath();
+	if (!Utils::FileSystem::exists(path))
+		return false;
+
+#if WIN32
+	FILE* file = fopen(path.c_str(), "rb");
+	if (file == nullptr)
+		return false;
+
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	fseek(file, 0, SEEK_SET);
 
-	if(!result)
+	if (size < (long)sizeof(MameNamesHeader))
 	{
-		LOG(LogError) << "Error parsing XML file \"" << xmlpath << "\"!\n	" << result.description();
-		return;
+		fclose(file);
+		return false;
 	}
 
-	for(pugi::xml_node gameNode = doc.child("game"); gameNode; gameNode = gameNode.next_sibling("game"))
+	mBuffer.resize(size);
+	bool read = fread(mBuffer.data(), 1, size, file) == (size_t)size;
+	fclose(file);
+
+	if (!read)
 	{
-		NamePair namePair = { gameNode.child("mamename").text().get(), gameNode.child("realname").text().get() };
-		mNamePairs.push_back(namePair);
+		mBuffer.clear();
+		return false;
 	}
 
-	// Read bios
-	xmlpath = ResourceManager::getInstance()->getResourcePath(":/mamebioses.xml");
+	mData = mBuffer.data();
+	mDataSize = size;
+#else
+	int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		return false;
 
-	if(!Utils::FileSystem::exists(xmlpath))
-		return;
+	struct stat info;
+	if (fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(MameNamesHeader))
+	{
+		close(fd);
+		return false;
+	}
+
+	void* data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (data == MAP_FAILED)
+		return false;
+
+	mData = (const char*)data;
+	mDataSize = info.st_size;
+	mMapped = true;
+#endif
+
+	const MameNamesHeader* header = (const MameNamesHeader*)mData;
 
-	LOG(LogInfo) << "Parsing XML file \"" << xmlpath << "\"...";
+	bool valid = header->magic == MAMENAMES_DB_MAGIC && header->version == MAMENAMES_DB_VERSION && header->dataSize == mDataSize &&
+		sizeof(MameNamesHeader) + ((size_t)header->nameCount * 2 + header->biosCount + header->deviceCount) * sizeof(unsigned int) <= mDataSize;
 
-	result = doc.load_file(xmlpath.c_str());
+	for (int i = 0; i < 3 && valid; i++)
+		valid = header->sourceSize[i] == sources.sourceSize[i] && header->sourceDate[i] == sources.sourceDate[i];
 
-	if(!result)
+	if (valid)
 	{
-		LOG(LogError) << "Error parsing XML file \"" << xmlpath << "\"!\n	" << result.description();
-		return;
+		// A truncated or corrupted file must not make lookups read outside of the data
+		size_t count = (size_t)header->nameCount * 2 + header->biosCount + header->deviceCount;
+		size_t stringsOffset = sizeof(MameNamesHeader) + count * sizeof(unsigned int);
+		const unsigned int* offsets = (const unsigned int*)(mData + sizeof(MameNamesHeader));
+
+		for (size_t i = 0; i < count && valid; i++)
+			valid = offsets[i] >= stringsOffset && offsets[i] < mDataSize;
+
+		if (valid && count > 0)
+			valid = mData[mDataSize - 1] == 0;
+
+		if (valid)
+			return true;
+
+		LOG(LogWarning) << "MAME names database is corrupted";
+	}
+	else
+		LOG(LogInfo) << "MAME names database is outdated";
+
+#if !WIN32
+	if (mMapped)
+		munmap((void*)mData, mDataSize);
+#endif
+
+	mBuffer.clear();
+	mData = nullptr;
+	mDataSize = 0;
+	mMapped = false;
+	return false;
+}
+
+void MameNames::buildDatabase(const MameNamesHeader& sources)
+{
+	std::vector<std::pair<std::string, std::string>> names;
+	std::vector<std::string> bioses;
+	std::vector<std::string> devices;
+
+	pugi::xml_document doc;
+
+	for (int i = 0; i < 3; i++)
+	{
+		if (sources.sourceSize[i] < 0)
+			continue;
+
+		std::string xmlpath = ResourceManager::getInstance()->getResourcePath(sSourceFiles[i]);
+
+		LOG(LogInfo) << "Parsing XML file \"" << xmlpath << "\"...";
+
+		const ResourceData data = ResourceManager::getInstance()->getFileData(sSourceFiles[i]);
+		pugi::xml_parse_result result = doc.load_buffer(data.ptr.get(), data.length);
+		if (!result)
+		{
+			LOG(LogError) << "Error parsing XML file \"" << xmlpath << "\"!\n	" << result.description();
+			continue;
+		}
+
+		if (i == 0)
+		{
+			for (pugi::xml_node gameNode = doc.child("game"); gameNode; gameNode = gameNode.next_sibling("game"))
+				names.push_back(std::make_pair(gameNode.child("mamename").text().get(), gameNode.child("realname").text().get()));
+		}
+		else
+		{
+			std::vector<std::string>& list = (i == 1 ? bioses : devices);
+			for (pugi::xml_node node = doc.child(i == 1 ? "bios" : "device"); node; node = node.next_sibling(i == 1 ? "bios" : "device"))
+				list.push_back(node.text().get());
+		}
 	}
 
-	for(pugi::xml_node biosNode = doc.child("bios"); biosNode; biosNode = biosNode.next_sibling("bios"))
+	// Sorted the same way the lookups compare, the first of duplicated names wins
+	std::stable_sort(names.begin(), names.end(), [](const std::pair<std::string, std::string>& a, const std::pair<std::string, std::string>& b) { return strcmp(a.first.c_str(), b.first.c_str()) < 0; });
+	names.erase(std::unique(names.begin(), names.end(), [](const std::pair<std::string, std::string>& a, const std::pair<std::string, std::string>& b) { return a.first == b.first; }), names.end());
+
+	for (auto list : { &bioses, &devices })
 	{
-		std::string bios = biosNode.text().get();
-		mMameBioses.insert(bios);
+		std::sort(list->begin(), list->end(), [](const std::string& a, const std::string& b) { return strcmp(a.c_str(), b.c_str()) < 0; });
+		list->erase(std::unique(list->begin(), list->end()), list->end());
 	}
 
-	// Read devices
-	xmlpath = ResourceManager::getInstance()->getResourcePath(":/mamedevices.xml");
+	MameNamesHeader header = sources;
+	header.nameCount = (unsigned int)names.size();
+	header.biosCount = (unsigned int)bioses.size();
+	header.deviceCount = (unsigned int)devices.size();
 
-	if(!Utils::FileSystem::exists(xmlpath))
-		return;
+	size_t stringsOffset = sizeof(MameNamesHeader) + ((size_t)header.nameCount * 2 + header.biosCount + header.deviceCount) * sizeof(unsigned int);
 
-	LOG(LogInfo) << "Parsing XML file \"" << xmlpath << "\"...";
+	std::vector<unsigned int> offsets;
+	offsets.reserve(header.nameCount * 2 + header.biosCount + header.deviceCount);
 
-	result = doc.load_file(xmlpath.c_str());
+	std::string strings;
 
-	if(!result)
+	auto addString = [&](const std::string& value)
 	{
-		LOG(LogError) << "Error parsing XML file \"" << xmlpath << "\"!\n	" << result.description();
-		return;
+		offsets.push_back((unsigned int)(stringsOffset + strings.size()));
+		strings.append(value.c_str(), value.size() + 1);
+	};
+
+	for (auto& name : names)
+	{
+		addString(name.first);
+		addString(name.second);
 	}
 
-	for(pugi::xml_node deviceNode = doc.child("device"); deviceNode; deviceNode = deviceNode.next_sibling("device"))
-	{		
-		std::string device = deviceNode.text().get();
-		mMameDevices.insert(device);
+	for (auto& bios : bioses)
+		addString(bios);
+
+	for (auto& device : devices)
+		addString(device);
+
+	header.dataSize = (unsigned int)(stringsOffset + strings.size());
+
+	mBuffer.resize(header.dataSize);
+	memcpy(mBuffer.data(), &header, sizeof(MameNamesHeader));
+	memcpy(mBuffer.data() + sizeof(MameNamesHeader), offsets.data(), offsets.size() * sizeof(unsigned int));
+	memcpy(mBuffer.data() + stringsOffset, strings.data(), strings.size());
+
+	mData = mBuffer.data();
+	mDataSize = mBuffer.size();
+
+	// Write to a temporary file first, another instance may be reading the current one
+	std::string path = getDatabasePath();
+	std::string tmpPath = path + ".tmp";
+
+	FILE* file = fopen(tmpPath.c_str(), "wb");
+	if (file == nullptr)
+	{
+		LOG(LogWarning) << "Unable to write MAME names database \"" << path << "\"";
+		return;
 	}
 
-} // MameNames
+	bool written = fwrite(mBuffer.data(), 1, mBuffer.size(), file) == mBuffer.size();
+	fclose(file);
 
-MameNames::~MameNames()
-{
+	if (written)
+	{
+		// rename replaces the file atomically on POSIX : readers see either the old or the new database, never none
+#if WIN32
+		Utils::FileSystem::removeFile(path);
+#endif
+		written = rename(tmpPath.c_str(), path.c_str()) == 0;
+	}
 
-} // ~MameNames
+	if (!written)
+	{
+		LOG(LogWarning) << "Unable to write MAME names database \"" << path << "\"";
+		Utils::FileSystem::removeFile(tmpPath);
+	}
+}
 
-std::string MameNames::getRealName(const std::string& _mameName)
+// Index of key in a sorted list of string offsets, stride is the number of offsets per entry
+static int findString(const char* data, const unsigned int* offsets, unsigned int count, unsigned int stride, const char* key)
 {
 	size_t start = 0;
-	size_t end   = mNamePairs.size();
+	size_t end   = count;
 
 	while(start < end)
 	{
 		const size_t index   = (start + end) / 2;
-		const int    compare = strcmp(mNamePairs[index].mameName.c_str(), _mameName.c_str());
+		const int    compare = strcmp(data + offsets[index * stride], key);
 
 		if(compare < 0)       start = index + 1;
 		else if( compare > 0) end   = index;
-		else                  return mNamePairs[index].realName;
+		else                  return (int)index;
 	}
 
+	return -1;
+}
+
+std::string MameNames::getRealName(const std::string& _mameName)
+{
+	if (mData == nullptr)
+		return _mameName;
+
+	const MameNamesHeader* header = (const MameNamesHeader*)mData;
+	const unsigned int* names = (const unsigned int*)(mData + sizeof(MameNamesHeader));
+
+	int index = findString(mData, names, header->nameCount, 2, _mameName.c_str());
+	if (index >= 0)
+		return mData + names[index * 2 + 1];
+
 	return _mameName;
 
 } // getRealName
 
 const bool MameNames::isBios(const std::string& _biosName)
 {
-	return (mMameBioses.find(_biosName) != mMameBioses.cend());
+	if (mData == nullptr)
+		return false;
+
+	const MameNamesHeader* header = (const MameNamesHeader*)mData;
+	const unsigned int* bioses = (const unsigned int*)(mData + sizeof(MameNamesHeader)) + header->nameCount * 2;
+
+	return findString(mData, bioses, header->biosCount, 1, _biosName.c_str()) >= 0;
 } // isBios
 
 const bool MameNames::isDevice(const std::string& _deviceName)
 {
-	return (mMameDevices.find(_deviceName) != mMameDevices.cend());
+	if (mData == nullptr)
+		return false;
+
+	const MameNamesHeader* header = (const MameNamesHeader*)mData;
+	const unsigned int* devices = (const unsigned int*)(mData + sizeof(MameNamesHeader)) + header->nameCount * 2 + header->biosCount;
+
+	return findString(mData, devices, header->deviceCount, 1, _deviceName.c_str()) >= 0;
 } // isDevice
@@ -4,7 +4,8 @@
 
 #include <string>
 #include <vector>
-#include <unordered_set>
+
+struct MameNamesHeader;
 
 class MameNames
 {
@@ -19,23 +20,19 @@ public:
 
 private:
 
-	struct NamePair
-	{
-		std::string mameName;
-		std::string realName;
-	};
-
-	typedef std::vector<NamePair> namePairVector;
-
 	 MameNames();
 	~MameNames();
 
-	static MameNames* sInstance;
+	bool loadDatabase(const MameNamesHeader& sources);
+	void buildDatabase(const MameNamesHeader& sources);
 
-	namePairVector mNamePairs;
+	static MameNames* sInstance;
 
-	std::unordered_set<std::string> mMameBioses;
-	std::unordered_set<std::string> mMameDevices;
+	// binary database, mapped from the file or built from the XML files
+	const char*       mData;
+	size_t            mDataSize;
+	bool              mMapped;
+	std::vector<char> mBuffer;
 
 }; // MameNames
 
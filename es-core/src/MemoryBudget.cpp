@@ -0,0 +1,164 @@
+#include "MemoryBudget.h"
+
+#include "Log.h"
+#include "Settings.h"
+#include <SDL_timer.h>
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+#define MEMORY_BUDGET_CHECK_DELAY 500
+
+namespace MemoryBudget
+{
+	static std::mutex sLock;
+	static std::map<int, Consumer> sConsumers;
+	static int sNextId = 0;
+	static int sElapsed = 0;
+	static bool sOverBudget = false;
+
+	// Resolved once, the budget is checked twice per second
+	static const int* memoryBudgetSetting() { static const int* slot = Settings::getInstance()->getIntSlot("MemoryBudget"); return slot; }
+
+	int add(const Consumer& consumer)
+	{
+		std::unique_lock<std::mutex> lock(sLock);
+
+		int id = ++sNextId;
+		sConsumers[id] = consumer;
+		return id;
+	}
+
+	void remove(int id)
+	{
+		std::unique_lock<std::mutex> lock(sLock);
+		sConsumers.erase(id);
+	}
+
+	// Caches are called without holding the lock : evicting can destroy objects which remove their own caches
+	static std::vector<std::pair<int, Consumer>> getConsumers()
+	{
+		std::unique_lock<std::mutex> lock(sLock);
+		return std::vector<std::pair<int, Consumer>>(sConsumers.cbegin(), sConsumers.cend());
+	}
+
+	static bool isRegistered(int id)
+	{
+		std::unique_lock<std::mutex> lock(sLock);
+		return sConsumers.find(id) != sConsumers.cend();
+	}
+
+	static size_t getTotalSize(const std::vector<std::pair<int, Consumer>>& consumers)
+	{
+		size_t total = 0;
+		for (auto& consumer : consumers)
+			total += consumer.second.getSize();
+
+		return total;
+	}
+
+	size_t getTotalSize()
+	{
+		return getTotalSize(getConsumers());
+	}
+
+	static void enforce()
+	{
+		int budgetMb = *memoryBudgetSetting();
+		if (budgetMb <= 0)
+			return;
+
+		size_t budget = (size_t)budgetMb * 1024 * 1024;
+
+		std::vector<std::pair<int, Consumer>> consumers = getConsumers();
+
+		size_t total = getTotalSize(consumers);
+		if (total <= budget)
+		{
+			sOverBudget = false;
+			return;
+		}
+
+		unsigned int now = SDL_GetTicks();
+
+		std::stable_sort(consumers.begin(), consumers.end(), [now](const std::pair<int, Consumer>& first, const std::pair<int, Consumer>& second)
+		{
+			const Consumer& a = first.second;
+			const Consumer& b = second.second;
+
+			if (a.priority != b.priority)
+				return a.priority < b.priority;
+
+			unsigned int lastUseA = a.getLastUse ? a.getLastUse() : now;
+			unsigned int lastUseB = b.getLastUse ? b.getLastUse() : now;
+			return lastUseA < lastUseB;
+		});
+
+		for (auto& entry : consumers)
+		{
+			const Consumer& consumer = entry.second;
+
+			// removed by a previous eviction, its owner may be gone
+			if (!consumer.evict || !isRegistered(entry.first))
+				continue;
+
+			size_t freed = consumer.evict(total - budget);
+			if (freed == 0)
+				continue;
+
+			LOG(LogDebug) << "MemoryBudget : evicted " << freed / 1024 << " KB from " << consumer.name;
+
+			// evicting from a cache can release memory from others (e.g. the textures of a view)
+			total = getTotalSize();
+			if (total <= budget)
+				break;
+		}
+
+		// warn once, the budget is checked again and again while over it
+		if (total > budget && !sOverBudget)
+		{
+			LOG(LogWarning) << "MemoryBudget : " << total / 1024 / 1024 << " MB still in use, over the " << budgetMb << " MB budget\n" << getReport();
+		}
+
+		sOverBudget = (total > budget);
+	}
+
+	void update(int deltaTime)
+	{
+		sElapsed += deltaTime;
+		if (sElapsed < MEMORY_BUDGET_CHECK_DELAY)
+			return;
+
+		sElapsed = 0;
+		enforce();
+	}
+
+	std::string getReport()
+	{
+		std::vector<std::pair<int, Consumer>> consumers = getConsumers();
+
+		std::stringstream ss;
+		ss << std::fixed << std::setprecision(1);
+
+		size_t total = 0;
+		for (auto& consumer : consumers)
+		{
+			size_t size = consumer.second.getSize();
+			total += size;
+
+			ss << consumer.second.name << ": " << size / 1024.0f / 1024.0f << " MB\n";
+		}
+
+		ss << "Total: " << total / 1024.0f / 1024.0f << " MB";
+
+		int budgetMb = *memoryBudgetSetting();
+		if (budgetMb > 0)
+			ss << " / " << budgetMb << " MB";
+
+		return ss.str();
+	}
+
+} // MemoryBudget::
@@ -0,0 +1,35 @@
+#pragma once
+#ifndef ES_CORE_MEMORY_BUDGET_H
+#define ES_CORE_MEMORY_BUDGET_H
+
+#include <functional>
+#include <string>
+
+// Keeps the memory used by all the caches (textures, fonts, sounds, videos, views...) under the "MemoryBudget" setting.
+// When the total is over budget, caches are asked to evict in priority order, then least recently used first.
+namespace MemoryBudget
+{
+	struct Consumer
+	{
+		std::string name;
+		int priority; // caches with the lowest priority are evicted first
+
+		std::function<size_t()> getSize;			// bytes in use
+		std::function<unsigned int()> getLastUse;	// SDL ticks of the last use, null if the cache is always in use
+		std::function<size_t(size_t)> evict;		// frees up to the given bytes if it can, returns the bytes freed. null if nothing can be evicted
+	};
+
+	int  add(const Consumer& consumer);
+	void remove(int id);
+
+	// Checks the budget twice per second, called by the window on each frame
+	void update(int deltaTime);
+
+	size_t getTotalSize();
+
+	// One line per cache, e.g. "Textures: 42.1 MB"
+	std::string getReport();
+
+} // MemoryBudget::
+
+#endif // ES_CORE_MEMORY_BUDGET_H
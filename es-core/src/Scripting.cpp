@@ -2,35 +2,314 @@
 #include "Log.h"
 #include "platform.h"
 #include "utils/FileSystemUtil.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <ctime>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if !WIN32
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+// The scripts of an event are listed once, and listed again only when one of the script directories changes.
+// Directories are checked at most every SCRIPTING_CHECK_DELAY ms, so firing an event without scripts costs a lookup.
+#define SCRIPTING_CHECK_DELAY   2000
+
+// Events that don't need to complete before ES continues are run by a background thread, with a timeout.
+// An event fired again while still queued only updates its arguments, so rapid-fire events run once.
+#define SCRIPTING_MAX_PENDING   16
+#define SCRIPTING_ASYNC_TIMEOUT 10000
 
 namespace Scripting
 {
+	struct EventScripts
+	{
+		std::vector<std::string> scripts;
+		std::vector<time_t> directoryDates;
+		time_t listed; // wall clock second of the listing, directory dates have the same resolution
+		std::chrono::steady_clock::time_point checked;
+	};
+
+	struct PendingEvent
+	{
+		std::string eventName;
+		std::string arg1;
+		std::string arg2;
+	};
+
+	static std::mutex sRegistryLock;
+	static std::map<std::string, EventScripts> sRegistry;
+
+	struct EventQueue
+	{
+		EventQueue() : running(false) { }
+
+		std::mutex lock;
+		std::condition_variable changed;
+		std::deque<PendingEvent> events;
+		bool running;
+	};
+
+	// Never destroyed : the executor thread still waits on it when static objects are destroyed at exit
+	static EventQueue* sQueue = nullptr;
+	static std::mutex sQueueCreateLock;
+
+	// game-start & game-end scripts must be done before launching or when back, quit/reboot/shutdown before exiting
+	static bool isBlockingEvent(const std::string& eventName)
+	{
+		return eventName == "game-start" || eventName == "game-end" || eventName == "quit" || eventName == "reboot" || eventName == "shutdown";
+	}
+
+	// ES is about to exit : the queued events are run first, the executor thread won't outlive it
+	static bool isExitEvent(const std::string& eventName)
+	{
+		return eventName == "quit" || eventName == "reboot" || eventName == "shutdown";
+	}
+
+	// Events describing a selection that a blocking event supersedes
+	static bool isSelectionEvent(const std::string& eventName)
+	{
+		return eventName == "game-selected";
+	}
+
+	static std::vector<std::string> getScriptDirectories(const std::string& eventName)
+	{
+		// the parent folders are included to notice when the folder of an event is created
+		return std::vector<std::string> {
+			Utils::FileSystem::getExePath() + "/scripts",
+			Utils::FileSystem::getExePath() + "/scripts/" + eventName,
+			Utils::FileSystem::getHomePath() + "/.emulationstation/scripts",
+			Utils::FileSystem::getHomePath() + "/.emulationstation/scripts/" + eventName
+		};
+	}
+
+	static std::vector<time_t> getDirectoryDates(const std::vector<std::string>& directories)
+	{
+		std::vector<time_t> dates;
+		for (auto directory : directories)
+			dates.push_back(Utils::FileSystem::isDirectory(directory) ? Utils::FileSystem::getFileModificationDate(directory) : 0);
+
+		return dates;
+	}
+
+	static std::vector<std::string> getEventScripts(const std::string& eventName)
+	{
+		auto now = std::chrono::steady_clock::now();
+
+		std::unique_lock<std::mutex> lock(sRegistryLock);
+
+		auto it = sRegistry.find(eventName);
+		if (it != sRegistry.cend() && now - it->second.checked < std::chrono::milliseconds(SCRIPTING_CHECK_DELAY))
+			return it->second.scripts;
+
+		std::vector<std::string> directories = getScriptDirectories(eventName);
+		std::vector<time_t> dates = getDirectoryDates(directories);
+
+		EventScripts& entry = sRegistry[eventName];
+		entry.checked = now;
+
+		if (it != sRegistry.cend() && entry.directoryDates == dates)
+		{
+			// A directory changed during the second of the listing can change again without its date changing :
+			// the listing is only trusted once its dates are older than it
+			bool sameSecond = false;
+			for (auto date : dates)
+				if (date >= entry.listed)
+					sameSecond = true;
+
+			if (!sameSecond)
+				return entry.scripts;
+		}
+
+		entry.directoryDates = dates;
+		entry.listed = time(nullptr);
+		entry.scripts.clear();
+
+		// exepath, then homepath
+		for (int i = 1; i < (int)directories.size(); i += 2)
+		{
+			if (dates[i] == 0)
+				continue;
+
+			std::list<std::string> scripts = Utils::FileSystem::getDirContent(directories[i]);
+			std::vector<std::string> sorted(scripts.cbegin(), scripts.cend());
+			std::sort(sorted.begin(), sorted.end());
+
+			for (auto script : sorted)
+				if (!Utils::FileSystem::isDirectory(script))
+					entry.scripts.push_back(script);
+		}
+
+		return entry.scripts;
+	}
+
+	static std::string getCommandLine(const std::string& script, const std::string& arg1, const std::string& arg2)
+	{
+		return script + " \"" + arg1 + "\" \"" + arg2 + "\"";
+	}
+
+	// Runs a script in its own process group, killed with its children if it exceeds the timeout
+	static void runScript(const std::string& command, int timeout)
+	{
+#if WIN32
+		runSystemCommand(command, "", NULL);
+#else
+		pid_t pid = fork();
+		if (pid < 0)
+		{
+			LOG(LogError) << "Unable to start script " << command;
+			return;
+		}
+
+		if (pid == 0)
+		{
+			setpgid(0, 0);
+			execl("/bin/sh", "sh", "-c", command.c_str(), (char*)NULL);
+			_exit(127);
+		}
+
+		setpgid(pid, pid);
+
+		auto start = std::chrono::steady_clock::now();
+		int status;
+
+		while (waitpid(pid, &status, WNOHANG) == 0)
+		{
+			if (std::chrono::steady_clock::now() - start > std::chrono::milliseconds(timeout))
+			{
+				LOG(LogWarning) << "Script timed out after " << timeout << "ms, killing " << command;
+
+				kill(-pid, SIGTERM);
+				std::this_thread::sleep_for(std::chrono::milliseconds(500));
+				kill(-pid, SIGKILL);
+				waitpid(pid, &status, 0);
+				return;
+			}
+
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+#endif
+	}
+
+	static void executorThreadProc(EventQueue* queue)
+	{
+		std::unique_lock<std::mutex> lock(queue->lock);
+
+		while (true)
+		{
+			queue->changed.wait(lock, [queue] { return !queue->events.empty(); });
+
+			PendingEvent event = queue->events.front();
+			queue->events.pop_front();
+			queue->running = true;
+
+			lock.unlock();
+
+			for (auto script : getEventScripts(event.eventName))
+			{
+				std::string command = getCommandLine(script, event.arg1, event.arg2);
+				LOG(LogDebug) << "  executing: " << command;
+				runScript(command, SCRIPTING_ASYNC_TIMEOUT);
+			}
+
+			lock.lock();
+			queue->running = false;
+			queue->changed.notify_all();
+		}
+	}
+
+	static EventQueue* getEventQueue()
+	{
+		std::unique_lock<std::mutex> lock(sQueueCreateLock);
+		if (sQueue == nullptr)
+		{
+			sQueue = new EventQueue();
+			std::thread(executorThreadProc, sQueue).detach();
+		}
+
+		return sQueue;
+	}
+
+	static void queueEvent(const std::string& eventName, const std::string& arg1, const std::string& arg2)
+	{
+		EventQueue* queue = getEventQueue();
+		std::unique_lock<std::mutex> lock(queue->lock);
+
+		// coalesce with the same event if it didn't start yet
+		for (auto& pending : queue->events)
+		{
+			if (pending.eventName == eventName)
+			{
+				pending.arg1 = arg1;
+				pending.arg2 = arg2;
+				return;
+			}
+		}
+
+		if (queue->events.size() >= SCRIPTING_MAX_PENDING)
+		{
+			LOG(LogWarning) << "Too many pending script events, dropping " << queue->events.front().eventName;
+			queue->events.pop_front();
+		}
+
+		PendingEvent event;
+		event.eventName = eventName;
+		event.arg1 = arg1;
+		event.arg2 = arg2;
+		queue->events.push_back(event);
+
+		queue->changed.notify_all();
+	}
+
+	// Drops the queued selection events, which a game launch or an exit makes pointless. When waitAll is set,
+	// waits for the other queued events and the running one, so scripts still see them before ES exits
+	static void flushPendingEvents(bool waitAll)
+	{
+		std::unique_lock<std::mutex> lock(sQueueCreateLock);
+		EventQueue* queue = sQueue;
+		lock.unlock();
+
+		if (queue == nullptr)
+			return;
+
+		std::unique_lock<std::mutex> queueLock(queue->lock);
+
+		queue->events.erase(std::remove_if(queue->events.begin(), queue->events.end(), [](const PendingEvent& event) { return isSelectionEvent(event.eventName); }), queue->events.end());
+
+		if (waitAll)
+			queue->changed.wait(queueLock, [queue] { return queue->events.empty() && !queue->running; });
+	}
+
 	void fireEvent(const std::string& eventName, const std::string& arg1, const std::string& arg2)
 	{
 		LOG(LogDebug) << "fireEvent: " << eventName << " " << arg1 << " " << arg2;
 
-        std::list<std::string> scriptDirList;
-        std::string test;
-
-        // check in exepath
-        test = Utils::FileSystem::getExePath() + "/scripts/" + eventName;
-        if(Utils::FileSystem::exists(test))
-            scriptDirList.push_back(test);
-
-        // check in homepath
-        test = Utils::FileSystem::getHomePath() + "/.emulationstation/scripts/" + eventName;
-        if(Utils::FileSystem::exists(test))
-            scriptDirList.push_back(test);
-
-        for(std::list<std::string>::const_iterator dirIt = scriptDirList.cbegin(); dirIt != scriptDirList.cend(); ++dirIt) {
-            std::list<std::string> scripts = Utils::FileSystem::getDirContent(*dirIt);
-            for (std::list<std::string>::const_iterator it = scripts.cbegin(); it != scripts.cend(); ++it) {
-                // append folder to path
-                std::string script = *it + " \"" + arg1 + "\" \"" + arg2 + "\"";
-                LOG(LogDebug) << "  executing: " << script;
-                runSystemCommand(script, "", NULL);
-            }
-        }
+		std::vector<std::string> scripts = getEventScripts(eventName);
+		if (scripts.empty())
+			return;
+
+		if (!isBlockingEvent(eventName))
+		{
+			queueEvent(eventName, arg1, arg2);
+			return;
+		}
+
+		// a game launch doesn't wait for the background scripts, up to SCRIPTING_ASYNC_TIMEOUT each
+		flushPendingEvents(isExitEvent(eventName));
+
+		for (auto script : scripts)
+		{
+			std::string command = getCommandLine(script, arg1, arg2);
+			LOG(LogDebug) << "  executing: " << command;
+			runSystemCommand(command, "", NULL);
+		}
 	}
 
 } // Scripting::
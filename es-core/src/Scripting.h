@@ -6,6 +6,8 @@
 
 namespace Scripting
 {
+	// Runs the scripts of scripts/<eventName>. game-start, game-end, quit, reboot & shutdown wait for their scripts,
+	// other events are run in the background and coalesced when fired again before running.
 	void fireEvent(const std::string& eventName, const std::string& arg1="", const std::string& arg2="");
 } // Scripting::
 
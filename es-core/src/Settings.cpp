@@ -47,6 +47,7 @@ std::vector<const char*> settings_dont_save {
 Settings::Settings()
 {
 	mHasConfigRoot = false;
+	mLastListenerId = 0;
 	setDefaults();
 	loadFile();
 }
@@ -70,6 +71,7 @@ void Settings::setDefaults()
 	mBoolMap["ParseGamelistOnly"] = false;
 	mBoolMap["ShowHiddenFiles"] = false;
 	mBoolMap["DrawFramerate"] = false;
+	mBoolMap["SkipIdleFrames"] = true;
 	mBoolMap["ShowExit"] = true;		
 
 #if WIN32
@@ -102,6 +104,7 @@ void Settings::setDefaults()
 	mBoolMap["SaveGamelistsOnExit"] = true;
 	mBoolMap["OptimizeVRAM"] = true;	
 	mBoolMap["ThreadedLoading"] = true;	
+	mBoolMap["ResumeCache"] = false;
 	mBoolMap["MusicTitles"] = true;
 
 	mBoolMap["Debug"] = false;
@@ -122,6 +125,7 @@ void Settings::setDefaults()
 		mIntMap["MaxVRAM"] = 100;
 	#endif
 #endif
+	mIntMap["MemoryBudget"] = 0; // Mb shared by all the caches, 0 = no limit
 
 #if defined(_WIN32)
 	mBoolMap["HideWindow"] = false;
@@ -341,29 +345,63 @@ void Settings::loadFile()
 }
 
 //Print a warning message if the setting we're trying to get doesn't already exist in the map, then return the value in the map.
-#define SETTINGS_GETSET(type, mapName, getMethodName, setMethodName, defaultValue) type Settings::getMethodName(const std::string& name) \
+#define SETTINGS_GETSET(type, valueType, mapName, defaultMapName, getMethodName, setMethodName, slotMethodName, defaultValue) type Settings::getMethodName(const std::string& name) \
 { \
-	if(mapName.find(name) == mapName.cend()) \
+	auto it = mapName.find(name); \
+	if(it == mapName.cend()) \
 	{ \
 		/*LOG(LogError) << "Tried to use unset setting " << name << "!";*/ \
 		return defaultValue; \
 	} \
-	return mapName[name]; \
+	return it->second; \
 } \
 bool Settings::setMethodName(const std::string& name, type value) \
 { \
-	if (mapName.count(name) == 0 || mapName[name] != value) { \
-		mapName[name] = value; \
+	auto it = mapName.find(name); \
+	if (it != mapName.cend() && it->second == value) \
+		return false; \
 \
-		if (std::find(settings_dont_save.cbegin(), settings_dont_save.cend(), name) == settings_dont_save.cend()) \
-			mWasChanged = true; \
+	mapName[name] = value; \
 \
-		return true; \
+	if (std::find(settings_dont_save.cbegin(), settings_dont_save.cend(), name) == settings_dont_save.cend()) \
+		mWasChanged = true; \
+\
+	notifyChanged(name); \
+	return true; \
+} \
+const valueType* Settings::slotMethodName(const std::string& name) \
+{ \
+	auto it = mapName.find(name); \
+	if (it == mapName.cend()) \
+	{ \
+		/* also a default, so it's not saved unless it's changed */ \
+		defaultMapName[name] = defaultValue; \
+		it = mapName.insert(std::make_pair(name, defaultValue)).first; \
 	} \
-	return false; \
+	return &it->second; \
 }
 
-SETTINGS_GETSET(bool, mBoolMap, getBool, setBool, false);
-SETTINGS_GETSET(int, mIntMap, getInt, setInt, 0);
-SETTINGS_GETSET(float, mFloatMap, getFloat, setFloat, 0.0f);
-SETTINGS_GETSET(const std::string&, mStringMap, getString, setString, mEmptyString);
+SETTINGS_GETSET(bool, bool, mBoolMap, mDefaultBoolMap, getBool, setBool, getBoolSlot, false);
+SETTINGS_GETSET(int, int, mIntMap, mDefaultIntMap, getInt, setInt, getIntSlot, 0);
+SETTINGS_GETSET(float, float, mFloatMap, mDefaultFloatMap, getFloat, setFloat, getFloatSlot, 0.0f);
+SETTINGS_GETSET(const std::string&, std::string, mStringMap, mDefaultStringMap, getString, setString, getStringSlot, mEmptyString);
+
+int Settings::addChangedListener(const std::function<void(const std::string&)>& func)
+{
+	int id = ++mLastListenerId;
+	mChangedListeners[id] = func;
+	return id;
+}
+
+void Settings::removeChangedListener(int id)
+{
+	mChangedListeners.erase(id);
+}
+
+void Settings::notifyChanged(const std::string& name)
+{
+	// a copy, listeners may unregister themselves
+	auto listeners = mChangedListeners;
+	for (auto listener : listeners)
+		listener.second(name);
+}
@@ -2,7 +2,9 @@
 #ifndef ES_CORE_SETTINGS_H
 #define ES_CORE_SETTINGS_H
 
+#include <functional>
 #include <map>
+#include <string>
 
 //This is a singleton for storing settings.
 class Settings
@@ -24,6 +26,17 @@ public:
 	bool setFloat(const std::string& name, float value);
 	bool setString(const std::string& name, const std::string& value);
 
+	// Pointers to the values, they stay valid for the whole session : code reading a setting every frame or for every item
+	// resolves it once instead of looking the name up each time. A missing setting is created with the default of its type.
+	const bool* getBoolSlot(const std::string& name);
+	const int* getIntSlot(const std::string& name);
+	const float* getFloatSlot(const std::string& name);
+	const std::string* getStringSlot(const std::string& name);
+
+	// Listeners are called with the name of a setting each time its value changes
+	int addChangedListener(const std::function<void(const std::string&)>& func);
+	void removeChangedListener(int id);
+
 	std::map<std::string, std::string>& getStringMap() { return mStringMap; }
 
 private:
@@ -33,6 +46,7 @@ private:
 
 	//Clear everything and load default values.
 	void setDefaults();
+	void notifyChanged(const std::string& name);
 
 	std::map<std::string, bool> mBoolMap;
 	std::map<std::string, int> mIntMap;
@@ -45,6 +59,9 @@ private:
 	std::map<std::string, float> mDefaultFloatMap;
 	std::map<std::string, std::string> mDefaultStringMap;
 
+	std::map<int, std::function<void(const std::string&)>> mChangedListeners;
+	int mLastListenerId;
+
 	bool mWasChanged;
 	bool mHasConfigRoot;
 };
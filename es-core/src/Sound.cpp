@@ -1,11 +1,23 @@
 #include "Sound.h"
 #include "AudioManager.h"
 #include "Log.h"
+#include "resources/ResourceManager.h"
 #include "Settings.h"
 #include "ThemeData.h"
+#include <SDL_timer.h>
+#include <algorithm>
+#include <vector>
 
 std::map< std::string, std::shared_ptr<Sound> > Sound::sMap;
 
+static unsigned int sLastPlay = 0;
+
+// A sample played more recently may still be playing
+#define SOUND_EVICTION_DELAY 10000
+
+// Checked each time a sound is played, resolved once
+static const bool* enableSoundsSetting() { static const bool* slot = Settings::getInstance()->getBoolSlot("EnableSounds"); return slot; }
+
 std::shared_ptr<Sound> Sound::get(const std::string& path)
 {
 	auto it = sMap.find(path);
@@ -32,7 +44,7 @@ std::shared_ptr<Sound> Sound::getFromTheme(const std::shared_ptr<ThemeData>& the
 	return get(elem->get<std::string>("path"));
 }
 
-Sound::Sound(const std::string & path) : mSampleData(NULL), mPlaying(false)
+Sound::Sound(const std::string & path) : mSampleData(NULL), mPlaying(false), mLastPlay(0), mEvicted(false)
 {
 	loadFile(path);
 }
@@ -51,18 +63,23 @@ void Sound::loadFile(const std::string & path)
 void Sound::init()
 {
 	deinit();
+	mEvicted = false;
 
 	if (!AudioManager::isInitialized())
 		return;
 
-	if (mPath.empty() || !Utils::FileSystem::exists(mPath))
+	if (mPath.empty() || !ResourceManager::getInstance()->fileExists(mPath))
 		return;
 
-	if (!Settings::getInstance()->getBool("EnableSounds"))
+	if (!*enableSoundsSetting())
 		return;
 
-	//load wav file via SDL
-	mSampleData = Mix_LoadWAV(mPath.c_str());
+	// load wav file via SDL, through the resource manager so packed resources are found too
+	const ResourceData data = ResourceManager::getInstance()->getFileData(mPath);
+	if (data.ptr == nullptr)
+		return;
+
+	mSampleData = Mix_LoadWAV_RW(SDL_RWFromConstMem(data.ptr.get(), (int)data.length), 1);
 	if (mSampleData == nullptr) 
 	{
 		LOG(LogError) << "Error loading sound \"" << mPath << "\"!\n" << "	" << SDL_GetError();
@@ -83,19 +100,64 @@ void Sound::deinit()
 
 void Sound::play()
 {
+	// unloaded by the memory budget
+	if (mEvicted)
+		init();
+
 	if (mSampleData == nullptr)
 		return;
 
 	if (!AudioManager::isInitialized())
 		return;
 
-	if (!Settings::getInstance()->getBool("EnableSounds"))
+	if (!*enableSoundsSetting())
 		return;
 
 	mPlaying = true;
+	mLastPlay = sLastPlay = SDL_GetTicks();
 	Mix_PlayChannel(-1, mSampleData, 0);
 }
 
+size_t Sound::getTotalMemUsage()
+{
+	size_t total = 0;
+	for (auto it : sMap)
+		if (it.second->mSampleData != nullptr)
+			total += it.second->mSampleData->alen;
+
+	return total;
+}
+
+size_t Sound::evictUnused(size_t bytes)
+{
+	std::vector<Sound*> sounds;
+	for (auto it : sMap)
+		if (it.second->mSampleData != nullptr)
+			sounds.push_back(it.second.get());
+
+	std::sort(sounds.begin(), sounds.end(), [](const Sound* a, const Sound* b) { return a->mLastPlay < b->mLastPlay; });
+
+	unsigned int now = SDL_GetTicks();
+	size_t freed = 0;
+
+	for (auto sound : sounds)
+	{
+		if (freed >= bytes || now - sound->mLastPlay < SOUND_EVICTION_DELAY)
+			break;
+
+		freed += sound->mSampleData->alen;
+		sound->deinit();
+		sound->mEvicted = true;
+	}
+
+	return freed;
+}
+
+unsigned int Sound::getLastPlay()
+{
+	return sLastPlay;
+}
+
 bool Sound::isPlaying() const
 {
 	return mPlaying;
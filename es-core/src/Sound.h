@@ -13,11 +13,17 @@ class Sound
 	std::string mPath;
 	Mix_Chunk* mSampleData;
 	bool mPlaying;
+	unsigned int mLastPlay;
+	bool mEvicted;
 
 public:
 	static std::shared_ptr<Sound> get(const std::string& path);
 	static std::shared_ptr<Sound> getFromTheme(const std::shared_ptr<ThemeData>& theme, const std::string& view, const std::string& elem);
 
+	static size_t getTotalMemUsage(); // returns the size of the loaded samples (in bytes)
+	static size_t evictUnused(size_t bytes); // unloads samples not played recently, they're loaded again when played
+	static unsigned int getLastPlay();
+
 	~Sound();
 
 	void init();
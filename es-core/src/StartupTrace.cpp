@@ -0,0 +1,168 @@
+#include "StartupTrace.h"
+
+#include "utils/FileSystemUtil.h"
+#include "utils/StringUtil.h"
+#include "Log.h"
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <thread>
+
+static std::mutex sTraceLock;
+
+// Both are set during static initialisation, on the main thread, before main() runs
+static const std::chrono::steady_clock::time_point sStartTime = std::chrono::steady_clock::now();
+static const std::thread::id sMainThreadId = std::this_thread::get_id();
+
+// Last phase started on each thread
+static std::map<std::thread::id, int> sLastPhaseOfThread;
+
+std::vector<StartupTrace::PhaseInfo> StartupTrace::sPhases;
+bool StartupTrace::sReported = false;
+
+static int getElapsedTime()
+{
+	return (int)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - sStartTime).count();
+}
+
+StartupTrace::Phase::Phase(const std::string& name, const std::string& dependsOn)
+{
+	mIndex = StartupTrace::begin(name, dependsOn);
+}
+
+StartupTrace::Phase::~Phase()
+{
+	end();
+}
+
+void StartupTrace::Phase::end()
+{
+	if (mIndex < 0)
+		return;
+
+	StartupTrace::end(mIndex);
+	mIndex = -1;
+}
+
+int StartupTrace::begin(const std::string& name, const std::string& dependsOn)
+{
+	std::unique_lock<std::mutex> lock(sTraceLock);
+
+	if (sReported)
+		return -1;
+
+	std::thread::id threadId = std::this_thread::get_id();
+
+	PhaseInfo phase;
+	phase.name = name;
+	phase.mainThread = (threadId == sMainThreadId);
+	phase.start = getElapsedTime();
+	phase.end = -1;
+	phase.previous = -1;
+
+	if (!dependsOn.empty())
+		phase.dependsOn = Utils::String::split(dependsOn, ',');
+
+	auto it = sLastPhaseOfThread.find(threadId);
+	if (it != sLastPhaseOfThread.cend())
+		phase.previous = it->second;
+
+	sPhases.push_back(phase);
+
+	int index = (int)sPhases.size() - 1;
+	sLastPhaseOfThread[threadId] = index;
+	return index;
+}
+
+void StartupTrace::end(int index)
+{
+	std::unique_lock<std::mutex> lock(sTraceLock);
+
+	if (index >= 0 && index < (int)sPhases.size() && sPhases[index].end < 0)
+		sPhases[index].end = getElapsedTime();
+}
+
+std::string StartupTrace::getReportPath()
+{
+	std::string home = Utils::FileSystem::getHomePath();
+	return home + "/.emulationstation/es_startup.txt";
+}
+
+void StartupTrace::writeReport()
+{
+	std::unique_lock<std::mutex> lock(sTraceLock);
+
+	if (sReported)
+		return;
+
+	sReported = true;
+
+	int total = getElapsedTime();
+
+	// Phases still running are reported as ending now
+	for (auto& phase : sPhases)
+		if (phase.end < 0)
+			phase.end = total;
+
+	// Critical path : start from the phase that finished last, then repeatedly go to the
+	// predecessor (previous phase on the same thread or declared dependency) that finished last
+	std::vector<int> criticalPath;
+
+	int current = -1;
+	for (int i = 0; i < (int)sPhases.size(); i++)
+		if (sPhases[i].mainThread && (current < 0 || sPhases[i].end >= sPhases[current].end))
+			current = i;
+
+	while (current >= 0)
+	{
+		criticalPath.insert(criticalPath.begin(), current);
+
+		const PhaseInfo& phase = sPhases[current];
+		int next = phase.previous;
+
+		for (auto dep : phase.dependsOn)
+		{
+			for (int i = current; --i >= 0; )
+			{
+				if (sPhases[i].name != dep)
+					continue;
+
+				if (next < 0 || sPhases[i].end > sPhases[next].end)
+					next = i;
+
+				break;
+			}
+		}
+
+		current = next;
+	}
+
+	std::string path = getReportPath();
+	remove((path + ".bak").c_str());
+	rename(path.c_str(), (path + ".bak").c_str());
+
+	FILE* file = fopen(path.c_str(), "w");
+	if (file == NULL)
+	{
+		LOG(LogWarning) << "StartupTrace : unable to write " << path;
+		return;
+	}
+
+	fprintf(file, "Startup time : %d ms\n\n", total);
+	fprintf(file, "%-32s %8s %8s %8s  %s\n", "phase", "start", "end", "duration", "thread");
+
+	for (auto phase : sPhases)
+		fprintf(file, "%-32s %8d %8d %8d  %s\n", phase.name.c_str(), phase.start, phase.end, phase.end - phase.start, phase.mainThread ? "main" : "worker");
+
+	fprintf(file, "\nCritical path :\n");
+
+	for (auto index : criticalPath)
+	{
+		const PhaseInfo& phase = sPhases[index];
+		fprintf(file, "%-32s %8d ms\n", phase.name.c_str(), phase.end - phase.start);
+	}
+
+	fclose(file);
+
+	LOG(LogInfo) << "Startup done in " << total << " ms, see " << path;
+}
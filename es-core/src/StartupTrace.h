@@ -0,0 +1,50 @@
+#pragma once
+#ifndef ES_CORE_STARTUP_TRACE_H
+#define ES_CORE_STARTUP_TRACE_H
+
+#include <string>
+#include <vector>
+
+// Records how long each startup phase takes, and on which thread, then writes
+// a report to ~/.emulationstation/es_startup.txt (the previous one is kept as .bak)
+class StartupTrace
+{
+public:
+	// A phase lasts until end() is called or the object is destroyed.
+	// Phases run one after the other on the same thread depend on each other implicitly,
+	// dependsOn lists phases from other threads that must be done before this one starts
+	class Phase
+	{
+	public:
+		Phase(const std::string& name, const std::string& dependsOn = "");
+		~Phase();
+
+		void end();
+
+	private:
+		int mIndex;
+	};
+
+	// Writes the report. Phases started afterwards are ignored
+	static void writeReport();
+	static std::string getReportPath();
+
+private:
+	struct PhaseInfo
+	{
+		std::string name;
+		std::vector<std::string> dependsOn;
+		int previous;
+		bool mainThread;
+		int start;
+		int end;
+	};
+
+	static int begin(const std::string& name, const std::string& dependsOn);
+	static void end(int index);
+
+	static std::vector<PhaseInfo> sPhases;
+	static bool sReported;
+};
+
+#endif // ES_CORE_STARTUP_TRACE_H
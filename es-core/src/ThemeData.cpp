@@ -10,6 +10,9 @@
 #include "platform.h"
 #include "Settings.h"
 #include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
 
 std::vector<std::string> ThemeData::sSupportedViews { { "system" }, { "basic" }, { "detailed" }, { "grid" }, { "video" }, { "menu" }, { "screen" } };
 std::vector<std::string> ThemeData::sSupportedFeatures { { "video" }, { "carousel" }, { "z-index" }, { "visible" } };
@@ -275,9 +278,254 @@ std::map<std::string, std::map<std::string, ThemeData::ElementPropertyType>> The
 		{ "filledPath", PATH } } },
 };
 
+// Names declared in sElementMap, indexed by their id
+std::vector<std::string> ThemeData::ThemeElement::sPropertyNames = []()
+{
+	std::vector<std::string> names;
+
+	for (auto element : sElementMap)
+		for (auto prop : element.second)
+			if (std::find(names.cbegin(), names.cend(), prop.first) == names.cend())
+				names.push_back(prop.first);
+
+	return names;
+}();
+
+std::unordered_map<std::string, unsigned short> ThemeData::ThemeElement::sPropertyIds = []()
+{
+	std::unordered_map<std::string, unsigned short> ids;
+
+	for (unsigned short id = 0; id < sPropertyNames.size(); id++)
+		ids[sPropertyNames[id]] = id;
+
+	return ids;
+}();
+
+// Names that are not declared in sElementMap ( extended menuIcons ) are interned while parsing, by several threads.
+// The id map is copied on write, lookups read the current copy without taking the lock
+typedef std::unordered_map<std::string, unsigned short> PropertyIdMap;
+
+static std::shared_ptr<const PropertyIdMap> sCustomPropertyIds;
+static std::vector<std::string> sCustomPropertyNames;
+static std::mutex sCustomPropertyLock;
+
+int ThemeData::ThemeElement::getPropertyId(const std::string& prop)
+{
+	auto it = sPropertyIds.find(prop);
+	if (it != sPropertyIds.cend())
+		return it->second;
+
+	std::shared_ptr<const PropertyIdMap> customIds = std::atomic_load(&sCustomPropertyIds);
+	if (customIds == nullptr)
+		return -1;
+
+	auto custom = customIds->find(prop);
+	if (custom != customIds->cend())
+		return custom->second;
+
+	return -1;
+}
+
+unsigned short ThemeData::ThemeElement::internPropertyId(const std::string& prop)
+{
+	int id = getPropertyId(prop);
+	if (id >= 0)
+		return (unsigned short)id;
+
+	std::unique_lock<std::mutex> lock(sCustomPropertyLock);
+
+	// another thread may have interned it since
+	std::shared_ptr<PropertyIdMap> customIds = sCustomPropertyIds != nullptr ? std::make_shared<PropertyIdMap>(*sCustomPropertyIds) : std::make_shared<PropertyIdMap>();
+
+	auto custom = customIds->find(prop);
+	if (custom != customIds->cend())
+		return custom->second;
+
+	unsigned short newId = (unsigned short)(sPropertyNames.size() + sCustomPropertyNames.size());
+	sCustomPropertyNames.push_back(prop);
+	(*customIds)[prop] = newId;
+
+	std::atomic_store(&sCustomPropertyIds, std::shared_ptr<const PropertyIdMap>(customIds));
+	return newId;
+}
+
+std::string ThemeData::ThemeElement::getPropertyName(unsigned short id)
+{
+	if (id < sPropertyNames.size())
+		return sPropertyNames[id];
+
+	std::unique_lock<std::mutex> lock(sCustomPropertyLock);
+
+	id -= (unsigned short)sPropertyNames.size();
+	if (id < sCustomPropertyNames.size())
+		return sCustomPropertyNames[id];
+
+	return "";
+}
+
+const ThemeData::ThemeElement::Property* ThemeData::ThemeElement::find(const std::string& prop) const
+{
+	return find(getPropertyId(prop));
+}
+
+const ThemeData::ThemeElement::Property* ThemeData::ThemeElement::find(int propId) const
+{
+	if (propId < 0)
+		return nullptr;
+
+	for (auto it = mProperties.cbegin(); it != mProperties.cend(); it++)
+		if (it->first == propId)
+			return &it->second;
+
+	return nullptr;
+}
+
+void ThemeData::ThemeElement::setProperty(const std::string& prop, const Property& value)
+{
+	unsigned short id = internPropertyId(prop);
+
+	for (auto it = mProperties.begin(); it != mProperties.end(); it++)
+	{
+		if (it->first == id)
+		{
+			it->second = value;
+			return;
+		}
+	}
+
+	mProperties.push_back(std::pair<unsigned short, Property>(id, value));
+}
+
+std::vector<std::pair<std::string, ThemeData::ThemeElement::Property>> ThemeData::ThemeElement::getProperties() const
+{
+	std::vector<std::pair<std::string, Property>> ret;
+
+	for (auto it = mProperties.cbegin(); it != mProperties.cend(); it++)
+		ret.push_back(std::pair<std::string, Property>(getPropertyName(it->first), it->second));
+
+	return ret;
+}
+
+void ThemeData::ThemeElement::Property::clear()
+{
+	if (type == TYPE_STRING)
+		s.~basic_string();
+
+	type = TYPE_UINT;
+	i = 0;
+}
+
+ThemeData::ThemeElement::Property& ThemeData::ThemeElement::Property::operator= (const Property& other)
+{
+	if (this == &other)
+		return *this;
+
+	if (type == TYPE_STRING && other.type == TYPE_STRING)
+	{
+		s = other.s;
+		return *this;
+	}
+
+	clear();
+
+	switch (other.type)
+	{
+	case TYPE_PAIR:   new (&v) Vector2f(other.v); break;
+	case TYPE_STRING: new (&s) std::string(other.s); break;
+	case TYPE_UINT:   i = other.i; break;
+	case TYPE_FLOAT:  f = other.f; break;
+	case TYPE_BOOL:   b = other.b; break;
+	case TYPE_RECT:   new (&r) Vector4f(other.r); break;
+	}
+
+	type = other.type;
+	return *this;
+}
+
+// A rect can also be read as a pair of its first two values
+void ThemeData::ThemeElement::Property::get(Vector2f& out) const
+{
+	if (type == TYPE_PAIR)
+		out = v;
+	else if (type == TYPE_RECT)
+		out = Vector2f(r.x(), r.y());
+}
+
+void ThemeData::ThemeElement::Property::get(std::string& out) const { if (type == TYPE_STRING) out = s; }
+void ThemeData::ThemeElement::Property::get(unsigned int& out) const { if (type == TYPE_UINT) out = i; }
+void ThemeData::ThemeElement::Property::get(float& out) const { if (type == TYPE_FLOAT) out = f; }
+void ThemeData::ThemeElement::Property::get(bool& out) const { if (type == TYPE_BOOL) out = b; }
+void ThemeData::ThemeElement::Property::get(Vector4f& out) const { if (type == TYPE_RECT) out = r; }
+
 std::shared_ptr<ThemeData::ThemeMenu> ThemeData::mMenuTheme;
 ThemeData* ThemeData::mDefaultTheme = nullptr;
 
+// Parsed theme files, shared by all systems : every system theme.xml usually includes the same layout, font & menu files
+// Documents are never modified once parsed, variables & subsets are resolved when each ThemeData walks through them
+struct ThemeDocument
+{
+	time_t modificationDate;
+	bool used;
+	std::shared_ptr<pugi::xml_document> document;
+};
+
+static std::map<std::string, ThemeDocument> sDocumentCache;
+static std::mutex sDocumentCacheLock;
+
+static std::shared_ptr<pugi::xml_document> loadThemeDocument(const std::string& path, std::string& error)
+{
+	time_t modificationDate = Utils::FileSystem::getFileModificationDate(path);
+
+	{
+		std::unique_lock<std::mutex> lock(sDocumentCacheLock);
+
+		auto it = sDocumentCache.find(path);
+		if (it != sDocumentCache.cend() && it->second.modificationDate == modificationDate)
+		{
+			it->second.used = true;
+			return it->second.document;
+		}
+	}
+
+	// Parse outside the lock, systems are loading their themes in parallel
+	std::shared_ptr<pugi::xml_document> document = std::make_shared<pugi::xml_document>();
+
+	pugi::xml_parse_result result = document->load_file(path.c_str());
+	if (!result)
+	{
+		error = result.description();
+		return nullptr;
+	}
+
+	std::unique_lock<std::mutex> lock(sDocumentCacheLock);
+
+	ThemeDocument& entry = sDocumentCache[path];
+	if (entry.document == nullptr || entry.modificationDate != modificationDate)
+	{
+		entry.modificationDate = modificationDate;
+		entry.document = document;
+	}
+
+	entry.used = true;
+	return entry.document;
+}
+
+void ThemeData::purgeDocumentCache()
+{
+	std::unique_lock<std::mutex> lock(sDocumentCacheLock);
+
+	for (auto it = sDocumentCache.begin(); it != sDocumentCache.end(); )
+	{
+		if (!it->second.used)
+			it = sDocumentCache.erase(it);
+		else
+		{
+			it->second.used = false;
+			it++;
+		}
+	}
+}
+
 #define MINIMUM_THEME_FORMAT_VERSION 3
 #define CURRENT_THEME_FORMAT_VERSION 6
 
@@ -379,12 +627,12 @@ void ThemeData::loadFile(const std::string system, std::map<std::string, std::st
 	mVariables.insert(sysDataMap.cbegin(), sysDataMap.cend());
 	mVariables["lang"] = mLanguage;
 
-	pugi::xml_document doc;
-	pugi::xml_parse_result res = doc.load_file(path.c_str());
-	if(!res)
-		throw error << "XML parsing error: \n    " << res.description();
+	std::string parseError;
+	std::shared_ptr<pugi::xml_document> doc = loadThemeDocument(path, parseError);
+	if(doc == nullptr)
+		throw error << "XML parsing error: \n    " << parseError;
 
-	pugi::xml_node root = doc.child("theme");
+	pugi::xml_node root = doc->child("theme");
 	if(!root)
 		throw error << "Missing <theme> tag!";
 
@@ -532,15 +780,15 @@ void ThemeData::parseInclude(const pugi::xml_node& node)
 
 	mPaths.push_back(path);
 
-	pugi::xml_document includeDoc;
-	pugi::xml_parse_result result = includeDoc.load_file(path.c_str());
-	if (!result)
+	std::string parseError;
+	std::shared_ptr<pugi::xml_document> includeDoc = loadThemeDocument(path, parseError);
+	if (includeDoc == nullptr)
 	{
-		LOG(LogWarning) << "Error parsing file: \n    " << result.description() << "    from included file \"" << relPath << "\":\n    ";
+		LOG(LogWarning) << "Error parsing file: \n    " << parseError << "    from included file \"" << relPath << "\":\n    ";
 		return;
 	}
 
-	pugi::xml_node theme = includeDoc.child("theme");
+	pugi::xml_node theme = includeDoc->child("theme");
 	if (!theme)
 	{
 		LOG(LogWarning) << "Missing <theme> tag!" << "    from included file \"" << relPath << "\":\n    ";
@@ -935,7 +1183,7 @@ void ThemeData::parseElement(const pugi::xml_node& root, const std::map<std::str
 		else
 			type = typeIt->second;
 		
-		if (!overwrite && element.properties.find(node.name()) != element.properties.cend())
+		if (!overwrite && element.has(node.name()))
 			continue;
 
 		std::string str = resolveSystemVariable(mSystemThemeFolder, resolvePlaceholders(node.text().as_string()));
@@ -958,7 +1206,7 @@ void ThemeData::parseElement(const pugi::xml_node& root, const std::map<std::str
 					(float)atof(splits.at(2).c_str()), (float)atof(splits.at(3).c_str()));
 			}
 
-			element.properties[node.name()] = val;
+			element.setProperty(node.name(), val);
 			break;
 		}
 		case NORMALIZED_PAIR:
@@ -973,17 +1221,17 @@ void ThemeData::parseElement(const pugi::xml_node& root, const std::map<std::str
 				}
 
 				Vector2f val((float)atof(str.c_str()), (float)atof(str.c_str()));
-				element.properties[node.name()] = val;
+				element.setProperty(node.name(), val);
 				break;
 			}			
 
 			float first = atof(str.substr(0, divider).c_str());
 			float second = atof(str.substr(divider, std::string::npos).c_str());
-			element.properties[node.name()] = Vector2f(first, second);
+			element.setProperty(node.name(), Vector2f(first, second));
 			break;
 		}
 		case STRING:
-			element.properties[node.name()] = str;
+			element.setProperty(node.name(), str);
 			break;
 		case PATH:
 		{
@@ -1004,7 +1252,7 @@ void ThemeData::parseElement(const pugi::xml_node& root, const std::map<std::str
 				else if (element.type == "image" && path != "{random}" && path != "{random:thumbnail}" && path != "{random:marquee}" && path != "{random:image}")
 					LOG(LogWarning) << "unknow random element " << path;
 				else
-					element.properties[node.name()] = path;
+					element.setProperty(node.name(), path);
 
 				break;
 			}
@@ -1038,17 +1286,17 @@ void ThemeData::parseElement(const pugi::xml_node& root, const std::map<std::str
 				LOG(LogWarning) << ss.str();
 			}
 			else
-				element.properties[node.name()] = path;
+				element.setProperty(node.name(), path);
 
 			break;
 		}
 		case COLOR:
-			element.properties[node.name()] = getHexColor(str.c_str());
+			element.setProperty(node.name(), getHexColor(str.c_str()));
 			break;
 		case FLOAT:
 		{
 			//float floatVal = atof(str.c_str());  static_cast<float>(strtod(str.c_str(), 0));
-			element.properties[node.name()] = (float) atof(str.c_str()); //floatVal;
+			element.setProperty(node.name(), (float) atof(str.c_str())); //floatVal;
 			break;
 		}
 
@@ -1059,7 +1307,7 @@ void ThemeData::parseElement(const pugi::xml_node& root, const std::map<std::str
 			// 1*, t* (true), T* (True), y* (yes), Y* (YES)
 			bool boolVal = (first == '1' || first == 't' || first == 'T' || first == 'y' || first == 'Y');
 
-			element.properties[node.name()] = boolVal;
+			element.setProperty(node.name(), boolVal);
 			break;
 		}
 		default:
@@ -1352,9 +1600,10 @@ ThemeData::ThemeMenu::ThemeMenu(ThemeData* theme)
 	elem = theme->getElement("menu", "menuicons", "menuIcons");
 	if (elem)
 	{
-		for (auto prop : elem->properties)
+		for (auto prop : elem->getProperties())
 		{
-			std::string path = prop.second.s;
+			std::string path;
+			prop.second.get(path);
 			if (!path.empty() && ResourceManager::getInstance()->fileExists(path))
 				mMenuIcons[prop.first] = path;
 		}
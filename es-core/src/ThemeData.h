@@ -170,38 +170,104 @@ public:
 		bool extra;
 		std::string type;
 
+		// Tagged union : a property only stores the value type it was parsed as
 		struct Property
 		{
-			void operator= (const Vector2f& value)     { v = value; }
-			void operator= (const std::string& value)  { s = value; }
-			void operator= (const unsigned int& value) { i = value; }
-			void operator= (const float& value)        { f = value; }
-			void operator= (const bool& value)         { b = value; }
-			void operator= (const Vector4f& value)     { r = value; v = Vector2f(value.x(), value.y()); }
-
-			Vector2f     v;
-			std::string  s;
-			unsigned int i;
-			float        f;
-			bool         b;
-			Vector4f     r;
+			enum PropertyType : unsigned char
+			{
+				TYPE_PAIR,
+				TYPE_STRING,
+				TYPE_UINT,
+				TYPE_FLOAT,
+				TYPE_BOOL,
+				TYPE_RECT
+			};
+
+			Property()                           : type(TYPE_UINT)   { i = 0; }
+			Property(const Vector2f& value)      : type(TYPE_PAIR)   { new (&v) Vector2f(value); }
+			Property(const std::string& value)   : type(TYPE_STRING) { new (&s) std::string(value); }
+			Property(const unsigned int& value)  : type(TYPE_UINT)   { i = value; }
+			Property(const float& value)         : type(TYPE_FLOAT)  { f = value; }
+			Property(const bool& value)          : type(TYPE_BOOL)   { b = value; }
+			Property(const Vector4f& value)      : type(TYPE_RECT)   { new (&r) Vector4f(value); }
+			Property(const Property& other)      : type(TYPE_UINT)   { i = 0; *this = other; }
+			~Property() { clear(); }
+
+			Property& operator= (const Property& other);
+
+			void get(Vector2f& out) const;
+			void get(std::string& out) const;
+			void get(unsigned int& out) const;
+			void get(float& out) const;
+			void get(bool& out) const;
+			void get(Vector4f& out) const;
+
+			PropertyType type;
+
+			union
+			{
+				Vector2f     v;
+				std::string  s;
+				unsigned int i;
+				float        f;
+				bool         b;
+				Vector4f     r;
+			};
+
+		private:
+			void clear();
 		};
 
-		std::map< std::string, Property > properties;
-
 		template<typename T>
 		const T get(const std::string& prop) const
 		{
-			if(     std::is_same<T, Vector2f>::value)     return *(const T*)&properties.at(prop).v;
-			else if(std::is_same<T, std::string>::value)  return *(const T*)&properties.at(prop).s;
-			else if(std::is_same<T, unsigned int>::value) return *(const T*)&properties.at(prop).i;
-			else if(std::is_same<T, float>::value)        return *(const T*)&properties.at(prop).f;
-			else if(std::is_same<T, bool>::value)         return *(const T*)&properties.at(prop).b;
-			else if (std::is_same<T, Vector4f>::value)         return *(const T*)&properties.at(prop).r;
-			return T();
+			T ret = T();
+
+			const Property* property = find(prop);
+			if (property != nullptr)
+				property->get(ret);
+
+			return ret;
 		}
 
-		inline bool has(const std::string& prop) const { return (properties.find(prop) != properties.cend()); }
+		inline bool has(const std::string& prop) const { return find(prop) != nullptr; }
+
+		// Same as above with an interned id, to resolve the name once per call site. Only for the properties declared
+		// by sElementMap, which have an id from the start : static const int posId = ThemeData::ThemeElement::getPropertyId("pos");
+		template<typename T>
+		const T get(int propId) const
+		{
+			T ret = T();
+
+			const Property* property = find(propId);
+			if (property != nullptr)
+				property->get(ret);
+
+			return ret;
+		}
+
+		inline bool has(int propId) const { return find(propId) != nullptr; }
+
+		// -1 if no theme ever declared the property
+		static int getPropertyId(const std::string& prop);
+
+		void setProperty(const std::string& prop, const Property& value);
+
+		// name / value pairs, in the order they were parsed
+		std::vector<std::pair<std::string, Property>> getProperties() const;
+
+	private:
+		const Property* find(const std::string& prop) const;
+		const Property* find(int propId) const;
+
+		static unsigned short internPropertyId(const std::string& prop);
+		static std::string getPropertyName(unsigned short id);
+
+		static std::vector<std::string> sPropertyNames;
+		static std::unordered_map<std::string, unsigned short> sPropertyIds;
+
+		// Property names are interned from sElementMap, elements only keep their id
+		std::vector<std::pair<unsigned short, Property>> mProperties;
 	};
 
 private:
@@ -260,6 +326,9 @@ public:
 
 	static std::vector<Subset> getSubSet(const std::vector<Subset>& subsets, const std::string& subset);
 
+	// Releases the parsed theme files that were not used since the previous purge
+	static void purgeDocumentCache();
+
 	static void setDefaultTheme(ThemeData* theme);
 	static ThemeData* getDefaultTheme() { return mDefaultTheme; }
 	
@@ -3,29 +3,81 @@
 #include "components/HelpComponent.h"
 #include "components/ImageComponent.h"
 #include "components/TextComponent.h"
+#include "components/VideoVlcComponent.h"
 #include "resources/Font.h"
 #include "resources/TextureResource.h"
 #include "InputManager.h"
 #include "Log.h"
+#include "MemoryBudget.h"
 #include "Scripting.h"
+#include "Sound.h"
 #include <algorithm>
 #include <iomanip>
 #include <SDL_events.h>
 #include "guis/GuiInfoPopup.h"
 #include "components/AsyncNotificationComponent.h"
 #include "guis/GuiMsgBox.h"
+#include <mutex>
+
+static std::mutex mNotificationMessagesLock;
+
+// Settings read every frame, resolved once
+static const bool* drawFramerateSetting() { static const bool* slot = Settings::getInstance()->getBoolSlot("DrawFramerate"); return slot; }
+static const bool* drawClockSetting() { static const bool* slot = Settings::getInstance()->getBoolSlot("DrawClock"); return slot; }
+static const bool* skipIdleFramesSetting() { static const bool* slot = Settings::getInstance()->getBoolSlot("SkipIdleFrames"); return slot; }
+static const int* screenSaverTimeSetting() { static const int* slot = Settings::getInstance()->getIntSlot("ScreenSaverTime"); return slot; }
 
 Window::Window() : mNormalizeNextUpdate(false), mFrameTimeElapsed(0), mFrameCountElapsed(0), mAverageDeltaTime(10),
-  mAllowSleep(true), mSleeping(false), mTimeSinceLastInput(0), mScreenSaver(NULL), mRenderScreenSaver(false), mInfoPopup(NULL), mClockElapsed(0) // batocera
+  mAllowSleep(true), mSleeping(false), mTimeSinceLastInput(0), mScreenSaver(NULL), mRenderScreenSaver(false), mInfoPopup(NULL), mClockElapsed(0), // batocera
+  mInvalidated(true), mIdleFrames(0), mFrameCount(0)
 {	
 	mHelp = new HelpComponent(this);
 	mBackgroundOverlay = new ImageComponent(this);	
 
 	mSplash = NULL;	
+
+	// Caches of es-core reporting to the memory budget, cheapest to reload first
+	MemoryBudget::Consumer resumeCache;
+	resumeCache.name = "Resume cache";
+	resumeCache.priority = 0;
+	resumeCache.getSize = [] { return TextureResource::getResumeCacheSize(); };
+	resumeCache.evict = [](size_t bytes) { return TextureResource::releaseResumeCache(bytes); };
+	mMemoryConsumers.push_back(MemoryBudget::add(resumeCache));
+
+	MemoryBudget::Consumer sounds;
+	sounds.name = "Sounds";
+	sounds.priority = 1;
+	sounds.getSize = [] { return Sound::getTotalMemUsage(); };
+	sounds.getLastUse = [] { return Sound::getLastPlay(); };
+	sounds.evict = [](size_t bytes) { return Sound::evictUnused(bytes); };
+	mMemoryConsumers.push_back(MemoryBudget::add(sounds));
+
+	MemoryBudget::Consumer textures;
+	textures.name = "Textures";
+	textures.priority = 2;
+	textures.getSize = [] { return TextureResource::getTotalMemUsage(); };
+	textures.evict = [](size_t bytes) { return TextureResource::evictUnused(bytes); };
+	mMemoryConsumers.push_back(MemoryBudget::add(textures));
+
+	// glyphs & decoded video frames are in use as long as they exist : reported only
+	MemoryBudget::Consumer fonts;
+	fonts.name = "Fonts";
+	fonts.priority = 10;
+	fonts.getSize = [] { return Font::getTotalMemUsage(); };
+	mMemoryConsumers.push_back(MemoryBudget::add(fonts));
+
+	MemoryBudget::Consumer videos;
+	videos.name = "Videos";
+	videos.priority = 10;
+	videos.getSize = [] { return VideoVlcComponent::getTotalMemUsage(); };
+	mMemoryConsumers.push_back(MemoryBudget::add(videos));
 }
 
 Window::~Window()
 {
+	for (auto id : mMemoryConsumers)
+		MemoryBudget::remove(id);
+
 	for (auto extra : mScreenExtras)
 		delete extra;
 
@@ -47,6 +99,7 @@ void Window::pushGui(GuiComponent* gui)
 	}
 	mGuiStack.push_back(gui);
 	gui->updateHelpPrompts();
+	invalidate();
 }
 
 void Window::removeGui(GuiComponent* gui)
@@ -56,6 +109,7 @@ void Window::removeGui(GuiComponent* gui)
 		if(*i == gui)
 		{
 			i = mGuiStack.erase(i);
+			invalidate();
 
 			if(i == mGuiStack.cend() && mGuiStack.size()) // we just popped the stack and the stack is not empty
 			{
@@ -136,7 +190,7 @@ void Window::reactivateGui()
 		peekGui()->updateHelpPrompts();
 }
 
-void Window::deinit(bool deinitRenderer)
+void Window::deinit(bool deinitRenderer, bool keepTextureData)
 {
 	for (auto extra : mScreenExtras)
 		extra->onHide();
@@ -150,7 +204,9 @@ void Window::deinit(bool deinitRenderer)
 
 	TextureResource::resetCache();
 
+	TextureResource::setResumeUnload(keepTextureData);
 	ResourceManager::getInstance()->unloadAll();
+	TextureResource::setResumeUnload(false);
 
 	if (deinitRenderer)
 		Renderer::deinit();
@@ -158,12 +214,16 @@ void Window::deinit(bool deinitRenderer)
 
 void Window::textInput(const char* text)
 {
+	invalidate();
+
 	if(peekGui())
 		peekGui()->textInput(text);
 }
 
 void Window::input(InputConfig* config, Input input)
 {
+	invalidate();
+
 	if (mScreenSaver) {
 		if (mScreenSaver->isScreenSaverActive() && Settings::getInstance()->getBool("ScreenSaverControls") &&
 			((Settings::getInstance()->getString("ScreenSaverBehavior") == "slideshow") || 			
@@ -233,6 +293,8 @@ void Window::update(int deltaTime)
 	processPostedFunctions();
 	processNotificationMessages();
 
+	MemoryBudget::update(deltaTime);
+
 	if(mNormalizeNextUpdate)
 	{
 		mNormalizeNextUpdate = false;
@@ -246,7 +308,7 @@ void Window::update(int deltaTime)
 	{
 		mAverageDeltaTime = mFrameTimeElapsed / mFrameCountElapsed;
 
-		if(Settings::getInstance()->getBool("DrawFramerate"))
+		if(*drawFramerateSetting())
 		{
 			std::stringstream ss;
 
@@ -261,6 +323,12 @@ void Window::update(int deltaTime)
 
 			ss << "\nFont VRAM: " << fontVramUsageMb << " Tex VRAM: " << textureVramUsageMb <<
 				  " Tex Max: " << textureTotalUsageMb;
+
+			// video startup-to-first-frame latency
+			ss << "\nVideo start: " << VideoVlcComponent::getAverageStartupTime() << "ms";
+
+			// memory of all the caches
+			ss << "\n" << MemoryBudget::getReport();
 			mFrameDataText = std::unique_ptr<TextCache>(mDefaultFonts.at(1)->buildTextCache(ss.str(), 50.f, 50.f, 0xFF00FFFF));
 		}
 
@@ -269,7 +337,7 @@ void Window::update(int deltaTime)
 	}
 
 	/* draw the clock */ // batocera
-	if (Settings::getInstance()->getBool("DrawClock") && mClock) 
+	if (*drawClockSetting() && mClock) 
 	{
 		mClockElapsed -= deltaTime;
 		if (mClockElapsed <= 0)
@@ -301,7 +369,11 @@ void Window::update(int deltaTime)
 				setlocale(LC_TIME, oldLocale.c_str());
 #endif
 
-				mClock->setText(clockBuf);
+				if (mClock->getValue() != clockBuf)
+				{
+					mClock->setText(clockBuf);
+					invalidate();
+				}
 			}
 
 			mClockElapsed = 1000; // next update in 1000ms
@@ -322,6 +394,9 @@ void Window::render()
 {
 	Transform4x4f transform = Transform4x4f::Identity();
 
+	mFrameCount++;
+	TextureResource::onFrameRendered();
+
 	mRenderedHelpPrompts = false;
 
 	// draw only bottom and top of GuiStack (if they are different)
@@ -351,7 +426,7 @@ void Window::render()
 		if(!mRenderedHelpPrompts)
 			mHelp->render(transform);
 
-	if(Settings::getInstance()->getBool("DrawFramerate") && mFrameDataText)
+	if(*drawFramerateSetting() && mFrameDataText)
 	{
 		Renderer::setMatrix(Transform4x4f::Identity());
 		mDefaultFonts.at(1)->renderTextCache(mFrameDataText.get());
@@ -359,7 +434,7 @@ void Window::render()
 
 
         // clock // batocera
-	if (Settings::getInstance()->getBool("DrawClock") && mClock && (mGuiStack.size() < 2 || !Renderer::isSmallScreen()))
+	if (*drawClockSetting() && mClock && (mGuiStack.size() < 2 || !Renderer::isSmallScreen()))
 	{
 		mClock->render(transform);
 	//	Renderer::setMatrix(Transform4x4f::Identity());
@@ -373,7 +448,7 @@ void Window::render()
 	// pads // batocera
 	Renderer::setMatrix(Transform4x4f::Identity());
 
-	unsigned int screensaverTime = (unsigned int)Settings::getInstance()->getInt("ScreenSaverTime");
+	unsigned int screensaverTime = (unsigned int)*screenSaverTimeSetting();
 	if(mTimeSinceLastInput >= screensaverTime && screensaverTime != 0)
 		startScreenSaver();
 
@@ -403,6 +478,56 @@ void Window::render()
 	}
 }
 
+bool Window::isIdleFrame()
+{
+	// keep a few frames after the last change so double/triple buffered swap chains all get the final image
+	const int IDLE_GRACE_FRAMES = 3;
+
+	bool idle = *skipIdleFramesSetting() && !mInvalidated && mGuiStack.size() == 1 &&
+		(mInfoPopup == nullptr || !mInfoPopup->isRunning()) && !mRenderScreenSaver && !*drawFramerateSetting();
+
+	if (idle)
+	{
+		std::unique_lock<std::mutex> lock(mNotificationMessagesLock);
+		idle = mAsyncNotificationComponent.empty();
+	}
+
+	if (idle)
+	{
+		// render() is responsible for starting the screensaver and going to sleep
+		unsigned int screensaverTime = (unsigned int)*screenSaverTimeSetting();
+		idle = (screensaverTime == 0 || mTimeSinceLastInput < screensaverTime) && !TextureResource::hasPendingLoads() && !peekGui()->isAnimating();
+	}
+
+	if (idle)
+	{
+		for (auto extra : mScreenExtras)
+		{
+			if (extra->isAnimating())
+			{
+				idle = false;
+				break;
+			}
+		}
+	}
+
+	mInvalidated = false;
+
+	if (!idle)
+	{
+		mIdleFrames = 0;
+		return false;
+	}
+
+	if (mIdleFrames < IDLE_GRACE_FRAMES)
+	{
+		mIdleFrames++;
+		return false;
+	}
+
+	return true;
+}
+
 void Window::normalizeNextUpdate()
 {
 	mNormalizeNextUpdate = true;
@@ -618,6 +743,7 @@ void Window::setHelpPrompts(const std::vector<HelpPrompt>& prompts, const HelpSt
 	});
 
 	mHelp->setPrompts(addPrompts);
+	invalidate();
 }
 
 
@@ -628,6 +754,8 @@ void Window::onSleep()
 
 void Window::onWake()
 {
+	invalidate();
+
 	Scripting::fireEvent("wake");
 }
 
@@ -640,6 +768,8 @@ void Window::startScreenSaver()
 {
 	if (mScreenSaver && !mRenderScreenSaver)
 	{
+		invalidate();
+
 		for (auto extra : mScreenExtras)
 			extra->onScreenSaverActivate();
 
@@ -656,6 +786,7 @@ bool Window::cancelScreenSaver()
 {
 	if (mScreenSaver && mRenderScreenSaver)
 	{		
+		invalidate();
 		mScreenSaver->stopScreenSaver();
 		mRenderScreenSaver = false;
 		mScreenSaver->resetCounts();
@@ -679,8 +810,6 @@ void Window::renderScreenSaver()
 		mScreenSaver->renderScreenSaver();
 }
 
-static std::mutex mNotificationMessagesLock;
-
 void Window::displayNotificationMessage(std::string message, int duration)
 {
 	std::unique_lock<std::mutex> lock(mNotificationMessagesLock);
@@ -716,6 +845,7 @@ void Window::processNotificationMessages()
 		delete mInfoPopup;
 
 	mInfoPopup = new GuiInfoPopup(this, msg.first, msg.second);
+	invalidate();
 }
 
 void Window::registerNotificationComponent(AsyncNotificationComponent* pc)
@@ -767,10 +897,14 @@ void Window::processPostedFunctions()
 {
 	std::unique_lock<std::mutex> lock(mNotificationMessagesLock);
 
+	if (mFunctions.empty())
+		return;
+
 	for (auto func : mFunctions)
 		func(this);
 
 	mFunctions.clear();
+	invalidate();
 }
 
 void Window::onThemeChanged(const std::shared_ptr<ThemeData>& theme)
@@ -780,6 +914,7 @@ void Window::onThemeChanged(const std::shared_ptr<ThemeData>& theme)
 
 	mScreenExtras.clear();
 	mScreenExtras = ThemeData::makeExtras(theme, "screen", this);
+	invalidate();
 
 	std::stable_sort(mScreenExtras.begin(), mScreenExtras.end(), [](GuiComponent* a, GuiComponent* b) { return b->getZIndex() > a->getZIndex(); });
 
@@ -45,6 +45,7 @@ public:
 	public:
 		virtual void render(const Transform4x4f& parentTrans) = 0;
 		virtual void stop() = 0;
+		virtual bool isRunning() = 0;
 		virtual ~InfoPopup() {};
 	};
 
@@ -61,8 +62,13 @@ public:
 	void update(int deltaTime);
 	void render();
 
+	// Returns true when nothing on screen changed since the last rendered frames, so render/swap can be skipped
+	bool isIdleFrame();
+	void invalidate() { mInvalidated = true; }
+	unsigned int getFrameCount() { return mFrameCount; } // frames rendered so far, idle frames don't count
+
 	bool init(bool initRenderer);
-	void deinit(bool deinitRenderer);
+	void deinit(bool deinitRenderer, bool keepTextureData = false);
 
 	void normalizeNextUpdate();
 
@@ -127,6 +133,7 @@ private:
 	std::vector<GuiComponent*> mGuiStack;
 
 	std::vector< std::shared_ptr<Font> > mDefaultFonts;
+	std::vector<int> mMemoryConsumers;
 
 	int mFrameTimeElapsed;
 	int mFrameCountElapsed;
@@ -146,6 +153,10 @@ private:
 	unsigned int mTimeSinceLastInput;
 
 	bool mRenderedHelpPrompts;
+
+	bool mInvalidated;
+	int  mIdleFrames;
+	unsigned int mFrameCount;
 };
 
 #endif // ES_CORE_WINDOW_H
@@ -29,6 +29,7 @@ public:
 	void reset(); // set to frame 0
 
 	void update(int deltaTime) override;
+	bool isAnimating() override { return true; }
 	void render(const Transform4x4f& trans) override;
 
 	void onSizeChanged() override;
@@ -9,6 +9,9 @@ ComponentGrid::ComponentGrid(Window* window, const Vector2i& gridDimensions) : G
 {
 	assert(gridDimensions.x() > 0 && gridDimensions.y() > 0);
 
+	// cells are laid out inside the grid bounds
+	mCullable = true;
+
 	mSeparatorColor = ThemeData::getMenuTheme()->Text.separatorColor;
 	mCells.reserve(gridDimensions.x() * gridDimensions.y());
 
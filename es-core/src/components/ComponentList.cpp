@@ -183,9 +183,17 @@ void ComponentList::render(const Transform4x4f& parentTrans)
 	// draw our entries
 	std::vector<GuiComponent*> drawAfterCursor;
 	bool drawAll;
+	float rowY = 0;
 	for(unsigned int i = 0; i < mEntries.size(); i++)
 	{
 		auto& entry = mEntries.at(i);
+
+		// skip the rows scrolled out of our bounds
+		float rowHeight = getRowHeight(entry.data);
+		rowY += rowHeight;
+		if(rowY < mCameraOffset || rowY - rowHeight > mCameraOffset + mSize.y())
+			continue;
+
 		drawAll = !mFocused || i != (unsigned int)mCursor;
 		for(auto it = entry.data.elements.cbegin(); it != entry.data.elements.cend(); it++)
 		{
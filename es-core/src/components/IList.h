@@ -104,6 +104,11 @@ public:
 		return mScrollVelocity;
 	}
 
+	bool isAnimating() override
+	{
+		return mScrollVelocity != 0 || mTitleOverlayOpacity > 0 || GuiComponent::isAnimating();
+	}
+
 	void stopScrolling()
 	{
 		listInput(0);
@@ -170,6 +175,18 @@ public:
 		return mCursor;
 	}
 
+	// returns the object at the given offset from the cursor, wrapping around the list
+	inline const UserData& getObjectFromCursor(int offset) const
+	{
+		assert(size() > 0);
+
+		int index = (mCursor + offset) % size();
+		if (index < 0)
+			index += size();
+
+		return mEntries.at(index).object;
+	}
+
 	// entry management
 	void add(const Entry& e)
 	{
@@ -5,6 +5,7 @@
 #include "renderers/Renderer.h"
 #include "Settings.h"
 #include "ThemeData.h"
+#include "Window.h"
 
 #include "resources/TextureData.h"
 #include "utils/FileSystemUtil.h"
@@ -24,7 +25,7 @@ Vector2f ImageComponent::getSize() const
 
 ImageComponent::ImageComponent(Window* window, bool forceLoad, bool dynamic) : GuiComponent(window),
 	mTargetIsMax(false), mTargetIsMin(false), mFlipX(false), mFlipY(false), mTargetSize(0, 0), mColorShift(0xFFFFFFFF), mColorShiftEnd(0xFFFFFFFF),
-	mForceLoad(forceLoad), mDynamic(dynamic), mFadeOpacity(0), mFading(false), mRotateByTargetSize(false), mVisible(true),
+	mForceLoad(forceLoad), mDynamic(dynamic), mFadeOpacity(0), mFading(false), mRenderedFrame(0), mRotateByTargetSize(false), mVisible(true),
 	mTopLeftCrop(0.0f, 0.0f), mBottomRightCrop(1.0f, 1.0f), mMirror(0.0f, 0.0f), mAllowAsync(false),
 	mPadding(Vector4f(0, 0, 0, 0))
 {
@@ -361,31 +362,6 @@ void ImageComponent::updateVertices()
 	}
 }
 
-#include <SDL_opengl.h>
-
-#define N_ROUNDING_PIECES 10
-
-void DrawGLRoundedCorner(int x, int y, double sa, double arc, float r) 
-{	
-	// centre of the arc, for clockwise sense
-	float cent_x = x + r * cos(sa + ES_PI / 2);
-	float cent_y = y + r * sin(sa + ES_PI / 2);
-
-	// build up piecemeal including end of the arc
-	int n = ceil(N_ROUNDING_PIECES * arc / ES_PI * 2);
-	for (int i = 0; i <= n; i++) 
-	{
-		double ang = sa + arc * (double)i / (double)n;
-
-		// compute the next point
-		float next_x = cent_x + r * sin(ang);
-		float next_y = cent_y - r * cos(ang);
-	
-		glColor3f(1.0f, 1.0f, 1.0f);
-		glVertex2f(next_x, next_y);
-	}
-}
-
 void ImageComponent::render(const Transform4x4f& parentTrans)
 {
 	if (!mVisible)
@@ -403,6 +379,8 @@ void ImageComponent::render(const Transform4x4f& parentTrans)
 	// Don't use soft clip if rotation applied : let renderer do the work
 	if (mRotation == 0 && !Renderer::isVisibleOnScreen(trans.translation().x(), trans.translation().y(), mSize.x(), mSize.y()))
 		return;
+
+	mRenderedFrame = mWindow->getFrameCount();
 		
 	Renderer::setMatrix(trans);
 
@@ -748,6 +726,24 @@ void ImageComponent::update(int deltaTime)
 	}
 }
 
+bool ImageComponent::isAnimating()
+{
+	// waiting for an asynchronous texture, or the playlist has just switched to the next image
+	if (mLoadingTexture != nullptr || (mPlaylist != nullptr && mShowing && mPlaylistTimer == 0))
+		return true;
+
+	// the texture loads and fades in while it's drawn : keep drawing until it's fully visible
+	if (mTexture != nullptr && mRenderedFrame == mWindow->getFrameCount() && (mFading || !mTexture->isLoaded()))
+		return true;
+
+	return GuiComponent::isAnimating();
+}
+
+bool ImageComponent::isFadedIn()
+{
+	return mLoadingTexture == nullptr && !mFading && (mTexture == nullptr || mTexture->isLoaded());
+}
+
 bool ImageComponent::isTiled()
 { 
 	return mTexture != nullptr && mTexture->isTiled(); 
@@ -118,6 +118,8 @@ public:
 	virtual void onShow() override;
 	virtual void onHide() override;
 	virtual void update(int deltaTime);
+	bool isAnimating() override;
+	bool isFadedIn(); // the texture is loaded and the fade in is over : what is drawn won't change by itself
 
 	void setPlaylist(std::shared_ptr<IPlaylist> playList);
 
@@ -150,6 +152,7 @@ private:
 	unsigned char			mFadeOpacity;
 
 	bool					mFading;
+	unsigned int			mRenderedFrame; // last window frame that drew the image, fadeIn() only advances then
 	bool					mForceLoad;
 	bool					mDynamic;
 	bool					mRotateByTargetSize;
@@ -62,6 +62,7 @@ public:
 	bool input(InputConfig* config, Input input) override;
 	void update(int deltaTime) override;
 	void render(const Transform4x4f& parentTrans) override;
+	bool isAnimating() override;
 	virtual void applyTheme(const std::shared_ptr<ThemeData>& theme, const std::string& view, const std::string& element, unsigned int properties) override;
 
 	void onSizeChanged() override;
@@ -229,6 +230,19 @@ void ImageGridComponent<T>::update(int deltaTime)
 		(*it)->update(deltaTime);
 }
 
+template<typename T>
+bool ImageGridComponent<T>::isAnimating()
+{
+	if (IList<ImageGridData, T>::isAnimating())
+		return true;
+
+	for (auto it = mTiles.begin(); it != mTiles.end(); it++)
+		if ((*it)->isAnimating())
+			return true;
+
+	return false;
+}
+
 template<typename T>
 void ImageGridComponent<T>::topWindow(bool isTop)
 {
@@ -9,6 +9,7 @@ mCornerSize(16, 16),
 mEdgeColor(edgeColor), mCenterColor(centerColor),
 mVertices(NULL)
 {
+	mCullable = true;
 	mTimer = 0;
 	mAnimateTiming = 0;
 	mAnimateColor = 0xFFFFFFFF;
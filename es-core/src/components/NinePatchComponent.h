@@ -26,6 +26,7 @@ public:
 
 	void render(const Transform4x4f& parentTrans) override;
 	void update(int deltaTime) override;
+	bool isAnimating() override { return mAnimateTiming > 0 || GuiComponent::isAnimating(); }
 
 	void onSizeChanged() override;
 
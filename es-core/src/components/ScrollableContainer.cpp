@@ -8,7 +8,7 @@
 #define AUTO_SCROLL_SPEED 50 // ms between scrolls
 
 ScrollableContainer::ScrollableContainer(Window* window) : GuiComponent(window),
-	mAutoScrollDelay(0), mAutoScrollSpeed(0), mAutoScrollAccumulator(0), mScrollPos(0, 0), mScrollDir(0, 0), mAutoScrollResetAccumulator(0)
+	mAutoScrollDelay(0), mAutoScrollSpeed(0), mAutoScrollAccumulator(0), mScrollPos(0, 0), mScrollDir(0, 0), mAutoScrollResetAccumulator(0), mScrollChanged(false)
 {
 }
 
@@ -62,6 +62,8 @@ void ScrollableContainer::setScrollPos(const Vector2f& pos)
 
 void ScrollableContainer::update(int deltaTime)
 {
+	const Vector2f previousScrollPos = mScrollPos;
+
 	if(mAutoScrollSpeed != 0)
 	{
 		mAutoScrollAccumulator += deltaTime;
@@ -104,6 +106,8 @@ void ScrollableContainer::update(int deltaTime)
 			reset();
 	}
 
+	mScrollChanged = (mScrollPos != previousScrollPos);
+
 	GuiComponent::update(deltaTime);
 }
 
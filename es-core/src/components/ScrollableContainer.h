@@ -16,6 +16,7 @@ public:
 
 	void update(int deltaTime) override;
 	void render(const Transform4x4f& parentTrans) override;
+	bool isAnimating() override { return mScrollChanged || GuiComponent::isAnimating(); }
 
 private:
 	Vector2f getContentSize();
@@ -27,6 +28,7 @@ private:
 	int mAutoScrollAccumulator;
 	bool mAtEnd;
 	int mAutoScrollResetAccumulator;
+	bool mScrollChanged;
 };
 
 #endif // ES_CORE_COMPONENTS_SCROLLABLE_CONTAINER_H
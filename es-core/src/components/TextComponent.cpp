@@ -10,6 +10,7 @@ TextComponent::TextComponent(Window* window) : GuiComponent(window),
 	mRenderBackground(false), mGlowColor(0), mGlowSize(2), mPadding(Vector4f(0, 0, 0, 0)), mGlowOffset(Vector2f(0, 0)),
 	mReflection(0.0f, 0.0f), mReflectOnBorders(false)
 {	
+	mCullable = true;
 	mMarqueeOffset = 0;
 	mMarqueeOffset2 = 0;
 	mMarqueeTime = 0;
@@ -25,6 +26,7 @@ TextComponent::TextComponent(Window* window, const std::string& text, const std:
 	mRenderBackground(false), mGlowColor(0), mGlowSize(2), mPadding(Vector4f(0, 0, 0, 0)), mGlowOffset(Vector2f(0, 0)),
 	mReflection(0.0f, 0.0f), mReflectOnBorders(false)
 {
+	mCullable = true;
 	setFont(font);
 	setColor(color);
 	setBackgroundColor(bgcolor);
@@ -301,6 +303,7 @@ void TextComponent::onTextChanged()
 	if (!mFont || mText.empty())
 	{
 		mTextCache.reset();
+		mCullable = true;
 		return;
 	}
 
@@ -345,6 +348,11 @@ void TextComponent::onTextChanged()
 	}
 	else
 		mTextCache = std::shared_ptr<TextCache>(f->buildTextCache(f->wrapText(text, sx), Vector2f(0, 0), color, sx, mHorizontalAlignment, mLineSpacing));
+
+	// Reflection, glow and text larger than the box (scrolling or wrapped in a box too short) are drawn outside of the bounds
+	const Vector2f& textSize = mTextCache->metrics.size;
+	mCullable = mReflection.x() == 0 && mReflection.y() == 0 && ((mGlowColor & 0x000000FF) == 0 || mGlowSize == 0) &&
+		textSize.x() <= sx + 1 && textSize.y() <= sy + 1;
 }
 
 void TextComponent::update(int deltaTime)
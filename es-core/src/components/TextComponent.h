@@ -49,6 +49,7 @@ public:
 	void setPadding(const Vector4f padding) { mPadding = padding; }
 
 	virtual void update(int deltaTime);
+	bool isAnimating() override { return mMarqueeOffset != 0 || mMarqueeOffset2 != 0 || GuiComponent::isAnimating(); }
 
 protected:
 	virtual void onTextChanged();
@@ -77,6 +77,8 @@ public:
 
 	virtual void update(int deltaTime);
 
+	bool isAnimating() override { return mIsPlaying || mIsWaitingForVideoToStart || mStaticImage.isAnimating() || GuiComponent::isAnimating(); }
+
 	// Resize the video to fit this size. If one axis is zero, scale that axis to maintain aspect ratio.
 	// If both are non-zero, potentially break the aspect ratio.  If both are zero, no resizing.
 	// Can be set before or after a video is loaded.
@@ -144,6 +146,9 @@ public:
 
 	void setPlaylist(std::shared_ptr<IPlaylist> playList);
 
+	// Hint that the given video is likely to be played soon (next/previous game), so the player can read its dimensions ahead
+	virtual void prefetchVideoInfo(const std::string& /*path*/) { }
+
 protected:
 	std::shared_ptr<IPlaylist> mPlaylist;
 	std::function<bool()> mVideoEnded;
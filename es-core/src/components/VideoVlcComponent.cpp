@@ -2,12 +2,18 @@
 
 #include "renderers/Renderer.h"
 #include "resources/TextureResource.h"
+#include "utils/FileSystemUtil.h"
 #include "utils/StringUtil.h"
+#include "Log.h"
 #include "PowerSaver.h"
 #include "Settings.h"
 #include <vlc/vlc.h>
 #include <SDL_mutex.h>
+#include <SDL_timer.h>
+#include <atomic>
 #include <cmath>
+#include <deque>
+#include <thread>
 #include "ThemeData.h"
 
 #ifdef WIN32
@@ -18,17 +24,218 @@
 
 #define MATHPI          3.141592653589793238462643383279502884L
 
+#define VIDEO_PLAYER_POOL_SIZE		3
+#define VIDEO_PARSE_QUEUE_SIZE		4
+#define VIDEO_SIZE_CACHE_SIZE		1024
+
 libvlc_instance_t* VideoVlcComponent::mVLC = NULL;
 
+// Video dimensions are read once per file by a background thread, and shared by every component
+static std::map<std::string, Vector2i> sVideoSizes;
+static std::deque<std::string> sParseQueue;
+static std::mutex sParseMutex;
+static std::thread sParserThread;
+static bool sParserRunning = false;
+static bool sParserStopped = false;
+
+// Stopped media players, kept to be reused by the next video instead of being destroyed
+static std::vector<libvlc_media_player_t*> sPlayerPool;
+
+// Startup-to-first-frame latency
+static std::atomic<unsigned int> sStartupTimeTotal(0);
+static std::atomic<unsigned int> sStartupCount(0);
+
+// Decoded frames of all the videos
+static std::atomic<size_t> sSurfacesSize(0);
+
+static std::string getVlcPath(const std::string& path)
+{
+#ifdef WIN32
+	return Utils::String::replace(path, "/", "\\");
+#else
+	return path;
+#endif
+}
+
+static Vector2i parseVideoSize(libvlc_instance_t* vlc, const std::string& path)
+{
+	Vector2i size(0, 0);
+
+	libvlc_media_t* media = libvlc_media_new_path(vlc, getVlcPath(path).c_str());
+	if (media == nullptr)
+		return size;
+
+	// Get the media metadata so we can find the aspect ratio
+	libvlc_media_parse(media);
+
+	libvlc_media_track_t** tracks;
+	unsigned track_count = libvlc_media_tracks_get(media, &tracks);
+	for (unsigned track = 0; track < track_count; ++track)
+	{
+		if (tracks[track]->i_type == libvlc_track_video)
+		{
+			size = Vector2i(tracks[track]->video->i_width, tracks[track]->video->i_height);
+			break;
+		}
+	}
+
+	libvlc_media_tracks_release(tracks, track_count);
+	libvlc_media_release(media);
+
+	return size;
+}
+
+static void parseQueueProc(libvlc_instance_t* vlc)
+{
+	while (true)
+	{
+		std::string path;
+
+		{
+			std::unique_lock<std::mutex> lock(sParseMutex);
+			if (sParseQueue.empty())
+			{
+				sParserRunning = false;
+				return;
+			}
+
+			path = sParseQueue.front();
+			sParseQueue.pop_front();
+		}
+
+		Vector2i size = parseVideoSize(vlc, path);
+
+		std::unique_lock<std::mutex> lock(sParseMutex);
+
+		// the sizes of videos no longer on screen are cheap to parse again
+		if (sVideoSizes.size() >= VIDEO_SIZE_CACHE_SIZE)
+			sVideoSizes.clear();
+
+		sVideoSizes[path] = size;
+	}
+}
+
+// Returns true and fills size if the video was already parsed. Otherwise the file is queued for parsing,
+// in front of the queue when it's needed right now, at the back when it's a speculative prefetch
+static bool getParsedVideoSize(libvlc_instance_t* vlc, const std::string& path, Vector2i& size, bool urgent)
+{
+	std::unique_lock<std::mutex> lock(sParseMutex);
+
+	auto it = sVideoSizes.find(path);
+	if (it != sVideoSizes.cend())
+	{
+		size = it->second;
+
+		// a failure is reported once, to the component waiting for it : the file may be readable next time
+		if (size.x() == 0 || size.y() == 0)
+			sVideoSizes.erase(it);
+
+		return true;
+	}
+
+	auto queued = std::find(sParseQueue.begin(), sParseQueue.end(), path);
+	if (queued != sParseQueue.end())
+	{
+		if (!urgent || queued == sParseQueue.begin())
+			return false;
+
+		sParseQueue.erase(queued);
+	}
+
+	if (urgent)
+		sParseQueue.push_front(path);
+	else
+		sParseQueue.push_back(path);
+
+	// Prefetches that were not reached yet are useless when the cursor moves fast
+	while (sParseQueue.size() > VIDEO_PARSE_QUEUE_SIZE)
+		sParseQueue.pop_back();
+
+	if (!sParserRunning && !sParserStopped)
+	{
+		// the previous thread found the queue empty and is leaving
+		if (sParserThread.joinable())
+			sParserThread.join();
+
+		sParserRunning = true;
+		sParserThread = std::thread(parseQueueProc, vlc);
+	}
+
+	return false;
+}
+
+// The parser writes the size cache : it has to be stopped before the cache is destroyed at exit
+static struct ParserThreadStopper
+{
+	~ParserThreadStopper()
+	{
+		{
+			std::unique_lock<std::mutex> lock(sParseMutex);
+			sParserStopped = true;
+			sParseQueue.clear();
+		}
+
+		// waits for the file being parsed, if any
+		if (sParserThread.joinable())
+			sParserThread.join();
+	}
+} sParserThreadStopper;
+
+void VideoVlcComponent::clearVideoSizeCache()
+{
+	std::unique_lock<std::mutex> lock(sParseMutex);
+	sVideoSizes.clear();
+}
+
+static libvlc_media_player_t* acquirePlayer(libvlc_instance_t* vlc)
+{
+	if (sPlayerPool.size() > 0)
+	{
+		libvlc_media_player_t* player = sPlayerPool.back();
+		sPlayerPool.pop_back();
+		return player;
+	}
+
+	return libvlc_media_player_new(vlc);
+}
+
+static void releasePlayer(libvlc_media_player_t* player)
+{
+	libvlc_media_player_stop(player);
+
+	if (sPlayerPool.size() < VIDEO_PLAYER_POOL_SIZE)
+		sPlayerPool.push_back(player);
+	else
+		libvlc_media_player_release(player);
+}
+
+unsigned int VideoVlcComponent::getAverageStartupTime()
+{
+	unsigned int count = sStartupCount;
+	if (count == 0)
+		return 0;
+
+	return sStartupTimeTotal / count;
+}
+
+size_t VideoVlcComponent::getTotalMemUsage()
+{
+	return sSurfacesSize;
+}
+
 // VLC prepares to render a video frame.
 static void *lock(void *data, void **p_pixels)
 {
 	struct VideoContext *c = (struct VideoContext *)data;
 
-	int frame = (c->surfaceId ^ 1);
+	std::unique_lock<std::mutex> lock(c->mutex);
 
-	c->mutexes[frame].lock();
-	c->hasFrame[frame] = false;
+	// Pick a slot that is neither waiting to be uploaded nor being uploaded
+	int frame = 0;
+	while (frame == c->readySurface || frame == c->readSurface)
+		frame++;
+
+	c->writeSurface = frame;
 	*p_pixels = c->surfaces[frame];
 	return NULL; // Picture identifier, not needed here.
 }
@@ -38,11 +245,12 @@ static void unlock(void *data, void* /*id*/, void *const* /*p_pixels*/)
 {
 	struct VideoContext *c = (struct VideoContext *)data;
 
-	int frame = (c->surfaceId ^ 1);
+	std::unique_lock<std::mutex> lock(c->mutex);
 
-	c->surfaceId = frame;
-	c->hasFrame[frame] = true;
-	c->mutexes[frame].unlock();
+	// Publish the frame. An older frame not uploaded yet is simply dropped
+	c->readySurface = c->writeSurface;
+	c->writeSurface = -1;
+	c->frameCount++;
 }
 
 // VLC wants to display a video frame.
@@ -67,6 +275,9 @@ VideoVlcComponent::VideoVlcComponent(Window* window, std::string subtitles) :
 	mLoops = -1;
 	mCurrentLoop = 0;
 
+	mWaitingForVideoInfo = false;
+	mStartTicks = 0;
+
 	// Get an empty texture for rendering the video
 	mTexture = nullptr;// TextureResource::get("");
 	mEffect = VideoVlcFlags::VideoVlcEffect::BUMP;
@@ -118,6 +329,17 @@ void VideoVlcComponent::setMinSize(float width, float height)
 
 void VideoVlcComponent::onVideoStarted()
 {
+	if (mStartTicks != 0)
+	{
+		unsigned int elapsed = SDL_GetTicks() - mStartTicks;
+		mStartTicks = 0;
+
+		sStartupTimeTotal += elapsed;
+		sStartupCount++;
+
+		LOG(LogDebug) << "VideoVlcComponent : first frame of " << mVideoPath << " after " << elapsed << "ms";
+	}
+
 	VideoComponent::onVideoStarted();
 	resize();
 }
@@ -237,11 +459,27 @@ void VideoVlcComponent::render(const Transform4x4f& parentTrans)
 	GuiComponent::renderChildren(trans);
 	Renderer::setMatrix(trans);
 
-	// Build a texture for the video frame
+	// Upload the last decoded frame, only if a new one arrived since the previous render
 	if (initFromPixels)
 	{
-		int frame = mContext.surfaceId;
-		if (mContext.hasFrame[frame])
+		int frame = -1;
+
+#ifdef _RPI_
+		// Rpi : A lot of videos are encoded in 60fps on screenscraper
+		// Try to limit transfert to opengl textures to 30fps to save CPU
+		if (!Settings::getInstance()->getBool("OptimizeVideo") || mElapsed >= 40) // 40ms = 25fps, 33.33 = 30 fps
+#endif
+		{
+			std::unique_lock<std::mutex> lock(mContext.mutex);
+			if (mContext.readySurface >= 0)
+			{
+				frame = mContext.readySurface;
+				mContext.readySurface = -1;
+				mContext.readSurface = frame;
+			}
+		}
+
+		if (frame >= 0)
 		{
 			if (mTexture == nullptr)
 			{
@@ -249,19 +487,12 @@ void VideoVlcComponent::render(const Transform4x4f& parentTrans)
 				resize();
 			}
 
-#ifdef _RPI_
-			// Rpi : A lot of videos are encoded in 60fps on screenscraper
-			// Try to limit transfert to opengl textures to 30fps to save CPU
-			if (!Settings::getInstance()->getBool("OptimizeVideo") || mElapsed >= 40) // 40ms = 25fps, 33.33 = 30 fps
-#endif
-			{
-				mContext.mutexes[frame].lock();
-				mTexture->initFromExternalPixels(mContext.surfaces[frame], mVideoWidth, mVideoHeight);
-				mContext.hasFrame[frame] = false;
-				mContext.mutexes[frame].unlock();
+			// The slot is owned by the render thread until readSurface is cleared, VLC decodes into the other ones
+			mTexture->initFromExternalPixels(mContext.surfaces[frame], mVideoWidth, mVideoHeight);
 
-				mElapsed = 0;
-			}
+			std::unique_lock<std::mutex> lock(mContext.mutex);
+			mContext.readSurface = -1;
+			mElapsed = 0;
 		}
 	}
 
@@ -386,13 +617,18 @@ void VideoVlcComponent::setupContext()
 	if (mContext.valid)
 		return;
 
-	// Create an RGBA surface to render the video into
-	mContext.surfaces[0] = new unsigned char[mVideoWidth * mVideoHeight * 4];
-	mContext.surfaces[1] = new unsigned char[mVideoWidth * mVideoHeight * 4];
-	mContext.hasFrame[0] = false;
-	mContext.hasFrame[1] = false;
+	// Create the RGBA surfaces to render the video into
+	for (int i = 0; i < VIDEO_SURFACE_COUNT; i++)
+		mContext.surfaces[i] = new unsigned char[mVideoWidth * mVideoHeight * 4];
+
+	mContext.writeSurface = -1;
+	mContext.readySurface = -1;
+	mContext.readSurface = -1;
+	mContext.frameCount = 0;
 	mContext.component = this;
 	mContext.valid = true;
+	mContext.surfacesSize = (size_t)mVideoWidth * mVideoHeight * 4 * VIDEO_SURFACE_COUNT;
+	sSurfacesSize += mContext.surfacesSize;
 	resize();
 }
 
@@ -407,14 +643,20 @@ void VideoVlcComponent::freeContext()
 		mTexture = nullptr;
 	}
 
-	delete[] mContext.surfaces[0];
-	delete[] mContext.surfaces[1];
-	mContext.surfaces[0] = nullptr;
-	mContext.surfaces[1] = nullptr;
-	mContext.hasFrame[0] = false;
-	mContext.hasFrame[1] = false;
+	for (int i = 0; i < VIDEO_SURFACE_COUNT; i++)
+	{
+		delete[] mContext.surfaces[i];
+		mContext.surfaces[i] = nullptr;
+	}
+
+	mContext.writeSurface = -1;
+	mContext.readySurface = -1;
+	mContext.readSurface = -1;
 	mContext.component = NULL;
 	mContext.valid = false;
+
+	sSurfacesSize -= mContext.surfacesSize;
+	mContext.surfacesSize = 0;
 }
 
 void VideoVlcComponent::setupVLC(std::string subtitles)
@@ -500,94 +742,84 @@ void VideoVlcComponent::handleLooping()
 
 void VideoVlcComponent::startVideo()
 {
-	if (mIsPlaying)
+	if (mIsPlaying || mMediaPlayer != nullptr)
 		return;
 
+	// Make sure we have a video path
+	if (mVLC == nullptr || mVideoPath.empty())
+		return;
+
+	if (!mWaitingForVideoInfo)
+		mStartTicks = SDL_GetTicks();
+
 	mCurrentLoop = 0;
 	mVideoWidth = 0;
 	mVideoHeight = 0;
 
-#ifdef WIN32
-	std::string path(Utils::String::replace(mVideoPath, "/", "\\"));
-#else
-	std::string path(mVideoPath);
-#endif
-	// Make sure we have a video path
-	if (mVLC && (path.size() > 0))
-	{
-		// Set the video that we are going to be playing so we don't attempt to restart it
-		mPlayingVideoPath = mVideoPath;
+	// Set the video that we are going to be playing so we don't attempt to restart it
+	mPlayingVideoPath = mVideoPath;
 
-		// Open the media
-		mMedia = libvlc_media_new_path(mVLC, path.c_str());
-		if (mMedia)
-		{
-			// If we have a playlist : most videos have a fader, skip it 1 second
-			if (mPlaylist != nullptr && mConfig.startDelay == 0 && !mConfig.showSnapshotDelay && !mConfig.showSnapshotNoVideo)
-				libvlc_media_add_option(mMedia, ":start-time=0.7");
-
-			unsigned track_count;
-			// Get the media metadata so we can find the aspect ratio
-			libvlc_media_parse(mMedia);
-			libvlc_media_track_t** tracks;
-			track_count = libvlc_media_tracks_get(mMedia, &tracks);
-			for (unsigned track = 0; track < track_count; ++track)
-			{
-				if (tracks[track]->i_type == libvlc_track_video)
-				{
-					mVideoWidth = tracks[track]->video->i_width;
-					mVideoHeight = tracks[track]->video->i_height;
-					break;
-				}
-			}
-			libvlc_media_tracks_release(tracks, track_count);
-
-			// Make sure we found a valid video track
-			if ((mVideoWidth > 0) && (mVideoHeight > 0))
-			{
-				if (Settings::getInstance()->getBool("OptimizeVideo"))
-				{
-					// Avoid videos bigger than resolution
-					Vector2f maxSize(Renderer::getScreenWidth(), Renderer::getScreenHeight());
-										
-#ifdef _RPI_
-					// Temporary -> RPI -> Try to limit videos to 400x300 for performance benchmark
-					if (!Renderer::isSmallScreen())
-						maxSize = Vector2f(400, 300);
-#endif
+	// Dimensions are parsed in the background, update() starts the video once they are known
+	Vector2i videoSize;
+	mWaitingForVideoInfo = !getParsedVideoSize(mVLC, mVideoPath, videoSize, true);
+	if (mWaitingForVideoInfo)
+		return;
 
-					if (!mTargetSize.empty() && (mTargetSize.x() < maxSize.x() || mTargetSize.y() < maxSize.y()))
-						maxSize = mTargetSize;
+	mVideoWidth = videoSize.x();
+	mVideoHeight = videoSize.y();
 
+	// Make sure we found a valid video track
+	if ((mVideoWidth == 0) || (mVideoHeight == 0))
+		return;
 
-					// If video is bigger than display, ask VLC for a smaller image
-					auto sz = ImageIO::adjustPictureSize(Vector2i(mVideoWidth, mVideoHeight), Vector2i(mTargetSize.x(), mTargetSize.y()), mTargetIsMin);
-					if (sz.x() < mVideoWidth || sz.y() < mVideoHeight)
-					{
-						mVideoWidth = sz.x();
-						mVideoHeight = sz.y();
-					}
-				}
+	// Open the media
+	mMedia = libvlc_media_new_path(mVLC, getVlcPath(mVideoPath).c_str());
+	if (mMedia == nullptr)
+		return;
 
-				PowerSaver::pause();
-				setupContext();
+	// If we have a playlist : most videos have a fader, skip it 1 second
+	if (mPlaylist != nullptr && mConfig.startDelay == 0 && !mConfig.showSnapshotDelay && !mConfig.showSnapshotNoVideo)
+		libvlc_media_add_option(mMedia, ":start-time=0.7");
 
-				// Setup the media player
-				mMediaPlayer = libvlc_media_player_new_from_media(mMedia);
+	if (Settings::getInstance()->getBool("OptimizeVideo"))
+	{
+		// Avoid videos bigger than resolution
+		Vector2f maxSize(Renderer::getScreenWidth(), Renderer::getScreenHeight());
 
-				if (!Settings::getInstance()->getBool("VideoAudio"))
-					libvlc_audio_set_mute(mMediaPlayer, 1);
+#ifdef _RPI_
+		// Temporary -> RPI -> Try to limit videos to 400x300 for performance benchmark
+		if (!Renderer::isSmallScreen())
+			maxSize = Vector2f(400, 300);
+#endif
 
-				libvlc_media_player_play(mMediaPlayer);
-				libvlc_video_set_callbacks(mMediaPlayer, lock, unlock, display, (void*)&mContext);
-				libvlc_video_set_format(mMediaPlayer, "RGBA", (int)mVideoWidth, (int)mVideoHeight, (int)mVideoWidth * 4);
+		if (!mTargetSize.empty() && (mTargetSize.x() < maxSize.x() || mTargetSize.y() < maxSize.y()))
+			maxSize = mTargetSize;
 
-				// Update the playing state -> Useless now set by display() & onVideoStarted
-				//mIsPlaying = true;
-				//mFadeIn = 0.0f;
-			}
+		// If video is bigger than display, ask VLC for a smaller image
+		auto sz = ImageIO::adjustPictureSize(Vector2i(mVideoWidth, mVideoHeight), Vector2i(mTargetSize.x(), mTargetSize.y()), mTargetIsMin);
+		if (sz.x() < mVideoWidth || sz.y() < mVideoHeight)
+		{
+			mVideoWidth = sz.x();
+			mVideoHeight = sz.y();
 		}
 	}
+
+	PowerSaver::pause();
+	setupContext();
+
+	// Setup the media player, reusing a stopped one when available
+	mMediaPlayer = acquirePlayer(mVLC);
+	libvlc_media_player_set_media(mMediaPlayer, mMedia);
+
+	libvlc_audio_set_mute(mMediaPlayer, Settings::getInstance()->getBool("VideoAudio") ? 0 : 1);
+
+	libvlc_video_set_callbacks(mMediaPlayer, lock, unlock, display, (void*)&mContext);
+	libvlc_video_set_format(mMediaPlayer, "RGBA", (int)mVideoWidth, (int)mVideoHeight, (int)mVideoWidth * 4);
+	libvlc_media_player_play(mMediaPlayer);
+
+	// Update the playing state -> Useless now set by display() & onVideoStarted
+	//mIsPlaying = true;
+	//mFadeIn = 0.0f;
 }
 
 void VideoVlcComponent::stopVideo()
@@ -595,12 +827,13 @@ void VideoVlcComponent::stopVideo()
 	mIsPlaying = false;
 	mIsWaitingForVideoToStart = false;
 	mStartDelayed = false;
+	mWaitingForVideoInfo = false;
+	mStartTicks = 0;
 
-	// Release the media player so it stops calling back to us
+	// Stop the media player so it stops calling back to us, and give it back to the pool
 	if (mMediaPlayer)
 	{
-		libvlc_media_player_stop(mMediaPlayer);
-		libvlc_media_player_release(mMediaPlayer);
+		releasePlayer(mMediaPlayer);
 		mMediaPlayer = NULL;
 	}
 
@@ -615,6 +848,19 @@ void VideoVlcComponent::stopVideo()
 	PowerSaver::resume();
 }
 
+void VideoVlcComponent::prefetchVideoInfo(const std::string& path)
+{
+	if (mVLC == nullptr || path.empty())
+		return;
+
+	std::string fullPath = Utils::FileSystem::getCanonicalPath(path);
+	if (fullPath.empty() || !Utils::FileSystem::exists(fullPath))
+		return;
+
+	Vector2i videoSize;
+	getParsedVideoSize(mVLC, fullPath, videoSize, false);
+}
+
 void VideoVlcComponent::applyTheme(const std::shared_ptr<ThemeData>& theme, const std::string& view, const std::string& element, unsigned int properties)
 {
 	VideoComponent::applyTheme(theme, view, element, properties);
@@ -652,5 +898,10 @@ void VideoVlcComponent::applyTheme(const std::shared_ptr<ThemeData>& theme, cons
 void VideoVlcComponent::update(int deltaTime)
 {
 	mElapsed += deltaTime;
+
+	// Start the video as soon as its dimensions have been parsed
+	if (mWaitingForVideoInfo && mIsWaitingForVideoToStart && mVideoPath == mPlayingVideoPath)
+		startVideo();
+
 	VideoComponent::update(deltaTime);
 }
@@ -9,26 +9,38 @@ struct libvlc_instance_t;
 struct libvlc_media_t;
 struct libvlc_media_player_t;
 
+#define VIDEO_SURFACE_COUNT	3
+
+// Ring of decoded frames shared between the VLC decoding thread and the render thread.
+// VLC always writes into a slot that is neither the last completed frame nor the one being uploaded,
+// so neither thread ever waits on the other for more than a few index swaps.
 struct VideoContext
 {
 	VideoContext()
 	{
-		surfaces[0] = nullptr;
-		surfaces[1] = nullptr;
+		for (int i = 0; i < VIDEO_SURFACE_COUNT; i++)
+			surfaces[i] = nullptr;
+
 		component = nullptr;
 		valid = false;
-		hasFrame[0] = false;
-		hasFrame[1] = false;
-		surfaceId = 0;
+		writeSurface = -1;
+		readySurface = -1;
+		readSurface = -1;
+		frameCount = 0;
+		surfacesSize = 0;
 	}
 
-	int					surfaceId;
-	unsigned char*		surfaces[2];
-	std::mutex			mutexes[2];
-	bool				hasFrame[2];
+	unsigned char*		surfaces[VIDEO_SURFACE_COUNT];
+	std::mutex			mutex;
+
+	int					writeSurface;	// Slot VLC is currently decoding into
+	int					readySurface;	// Last completed frame not yet uploaded, -1 if none
+	int					readSurface;	// Slot being uploaded by the render thread
+	unsigned int		frameCount;		// Number of frames decoded since setupContext
 
 	VideoComponent*		component;
 	bool				valid;
+	size_t				surfacesSize;	// Bytes allocated for the surfaces
 };
 
 
@@ -57,6 +69,15 @@ class VideoVlcComponent : public VideoComponent
 public:
 	static void setupVLC(std::string subtitles);
 
+	// Average time between startVideo and the first decoded frame, in ms
+	static unsigned int getAverageStartupTime();
+
+	// Memory used by the decoded frames of all the videos, in bytes
+	static size_t getTotalMemUsage();
+
+	// Forgets the parsed video dimensions, when systems or themes are reloaded
+	static void clearVideoSizeCache();
+
 	VideoVlcComponent(Window* window, std::string subtitles = "");
 	virtual ~VideoVlcComponent();
 
@@ -79,6 +100,8 @@ public:
 
 	void	setColorShift(unsigned int color);
 
+	void prefetchVideoInfo(const std::string& path) override;
+
 private:
 	// Calculates the correct mSize from our resizing information (set by setResize/setMaxSize).
 	// Used internally whenever the resizing parameters or texture change.
@@ -114,6 +137,9 @@ private:
 
 	int								mCurrentLoop;
 	int								mLoops;
+
+	bool							mWaitingForVideoInfo;
+	unsigned int					mStartTicks;
 };
 
 #endif // ES_CORE_COMPONENTS_VIDEO_VLC_COMPONENT_H
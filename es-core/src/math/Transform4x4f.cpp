@@ -1,10 +1,60 @@
 #include "math/Transform4x4f.h"
 
+// SSE is always there on x86-64, NEON must be enabled by the toolchain (aarch64, or -mfpu=neon on armv7)
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define TRANSFORM4X4F_SSE
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define TRANSFORM4X4F_NEON
+#include <arm_neon.h>
+#endif
+
 const Transform4x4f Transform4x4f::operator*(const Transform4x4f& _other) const
 {
 	const float* tm = (float*)this;
 	const float* om = (float*)&_other;
 
+#if defined(TRANSFORM4X4F_SSE) || defined(TRANSFORM4X4F_NEON)
+	// each row of the result is a linear combination of our rows, same operation order as the scalar version
+	Transform4x4f result;
+	float*        rm = (float*)&result;
+
+#if defined(TRANSFORM4X4F_SSE)
+	const __m128 t0 = _mm_loadu_ps(tm);
+	const __m128 t1 = _mm_loadu_ps(tm + 4);
+	const __m128 t2 = _mm_loadu_ps(tm + 8);
+
+	for(int i = 0; i < 16; i += 4)
+	{
+		__m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(t0, _mm_set1_ps(om[i])), _mm_mul_ps(t1, _mm_set1_ps(om[i + 1]))), _mm_mul_ps(t2, _mm_set1_ps(om[i + 2])));
+		if(i == 12)
+			r = _mm_add_ps(r, _mm_loadu_ps(tm + 12));
+
+		_mm_storeu_ps(rm + i, r);
+	}
+#else
+	const float32x4_t t0 = vld1q_f32(tm);
+	const float32x4_t t1 = vld1q_f32(tm + 4);
+	const float32x4_t t2 = vld1q_f32(tm + 8);
+
+	for(int i = 0; i < 16; i += 4)
+	{
+		// no vmlaq here, fused multiply-add would change the rounding
+		float32x4_t r = vaddq_f32(vaddq_f32(vmulq_n_f32(t0, om[i]), vmulq_n_f32(t1, om[i + 1])), vmulq_n_f32(t2, om[i + 2]));
+		if(i == 12)
+			r = vaddq_f32(r, vld1q_f32(tm + 12));
+
+		vst1q_f32(rm + i, r);
+	}
+#endif
+
+	rm[ 3] = 0;
+	rm[ 7] = 0;
+	rm[11] = 0;
+	rm[15] = 1;
+
+	return result;
+#else
 	return
 	{
 		{
@@ -32,6 +82,7 @@ const Transform4x4f Transform4x4f::operator*(const Transform4x4f& _other) const
 			1
 		}
 	};
+#endif
 
 } // operator*
 
@@ -40,12 +91,24 @@ const Vector3f Transform4x4f::operator*(const Vector3f& _other) const
 	const float* tm = (float*)this;
 	const float* ov = (float*)&_other;
 
+#if defined(TRANSFORM4X4F_SSE)
+	float r[4];
+	_mm_storeu_ps(r, _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(tm), _mm_set1_ps(ov[0])), _mm_mul_ps(_mm_loadu_ps(tm + 4), _mm_set1_ps(ov[1]))), _mm_mul_ps(_mm_loadu_ps(tm + 8), _mm_set1_ps(ov[2]))), _mm_loadu_ps(tm + 12)));
+
+	return { r[0], r[1], r[2] };
+#elif defined(TRANSFORM4X4F_NEON)
+	float r[4];
+	vst1q_f32(r, vaddq_f32(vaddq_f32(vaddq_f32(vmulq_n_f32(vld1q_f32(tm), ov[0]), vmulq_n_f32(vld1q_f32(tm + 4), ov[1])), vmulq_n_f32(vld1q_f32(tm + 8), ov[2])), vld1q_f32(tm + 12)));
+
+	return { r[0], r[1], r[2] };
+#else
 	return
 	{
 		tm[ 0] * ov[0] + tm[ 4] * ov[1] + tm[ 8] * ov[2] + tm[12],
 		tm[ 1] * ov[0] + tm[ 5] * ov[1] + tm[ 9] * ov[2] + tm[13],
 		tm[ 2] * ov[0] + tm[ 6] * ov[1] + tm[10] * ov[2] + tm[14]
 	};
+#endif
 
 } // operator*
 
@@ -296,9 +359,25 @@ Transform4x4f& Transform4x4f::translate(const Vector3f& _translation)
 	float*       tm = (float*)this;
 	const float* tv = (float*)&_translation;
 
+#if defined(TRANSFORM4X4F_SSE)
+	float r[4];
+	_mm_storeu_ps(r, _mm_add_ps(_mm_loadu_ps(tm + 12), _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(tm), _mm_set1_ps(tv[0])), _mm_mul_ps(_mm_loadu_ps(tm + 4), _mm_set1_ps(tv[1]))), _mm_mul_ps(_mm_loadu_ps(tm + 8), _mm_set1_ps(tv[2])))));
+
+	tm[12] = r[0];
+	tm[13] = r[1];
+	tm[14] = r[2];
+#elif defined(TRANSFORM4X4F_NEON)
+	float r[4];
+	vst1q_f32(r, vaddq_f32(vld1q_f32(tm + 12), vaddq_f32(vaddq_f32(vmulq_n_f32(vld1q_f32(tm), tv[0]), vmulq_n_f32(vld1q_f32(tm + 4), tv[1])), vmulq_n_f32(vld1q_f32(tm + 8), tv[2]))));
+
+	tm[12] = r[0];
+	tm[13] = r[1];
+	tm[14] = r[2];
+#else
 	tm[12] += tm[ 0] * tv[0] + tm[ 4] * tv[1] + tm[ 8] * tv[2];
 	tm[13] += tm[ 1] * tv[0] + tm[ 5] * tv[1] + tm[ 9] * tv[2];
 	tm[14] += tm[ 2] * tv[0] + tm[ 6] * tv[1] + tm[10] * tv[2];
+#endif
 
 	return *this;
 
@@ -65,6 +65,11 @@ namespace Renderer
 	{
 		LOG(LogInfo) << "Creating window...";
 
+#if defined(USE_NULL_RENDERER)
+		// no display is needed, unless a driver is forced in the environment
+		SDL_setenv("SDL_VIDEODRIVER", "dummy", 0);
+#endif
+
 		if(SDL_Init(SDL_INIT_VIDEO) != 0)
 		{
 			LOG(LogError) << "Error initializing SDL!\n	" << SDL_GetError();
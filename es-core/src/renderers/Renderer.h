@@ -87,6 +87,7 @@ namespace Renderer
 	unsigned int createTexture     (const Texture::Type _type, const bool _linear, const bool _repeat, const unsigned int _width, const unsigned int _height, void* _data);
 	void         destroyTexture    (const unsigned int _texture);
 	void         updateTexture     (const unsigned int _texture, const Texture::Type _type, const unsigned int _x, const unsigned _y, const unsigned int _width, const unsigned int _height, void* _data);
+	void         copyToTexture     (const unsigned int _texture, const int _x, const int _y, const unsigned int _width, const unsigned int _height); // copies a region of the back buffer, window coordinates
 	void         bindTexture       (const unsigned int _texture);
 	void         drawLines         (const Vertex* _vertices, const unsigned int _numVertices, const Blend::Factor _srcBlendFactor = Blend::SRC_ALPHA, const Blend::Factor _dstBlendFactor = Blend::ONE_MINUS_SRC_ALPHA);
 	void         drawTriangleStrips(const Vertex* _vertices, const unsigned int _numVertices, const Blend::Factor _srcBlendFactor = Blend::SRC_ALPHA, const Blend::Factor _dstBlendFactor = Blend::ONE_MINUS_SRC_ALPHA);
@@ -114,6 +115,23 @@ namespace Renderer
 	void enableRoundCornerStencil(float x, float y, float size_x, float size_y, float radius);
 	void disableStencil();
 
+#if defined(USE_NULL_RENDERER)
+	// Null renderer : nothing is drawn, calls are only counted
+	struct Statistics
+	{
+		unsigned int frames;
+		unsigned int drawCalls;
+		unsigned int vertices;
+		unsigned int textureUploads;
+		size_t       textureBytes;
+		unsigned int textures;
+
+	}; // Statistics
+
+	const Statistics& getStatistics  ();
+	void              resetStatistics();
+#endif // USE_NULL_RENDERER
+
 } // Renderer::
 
 #endif // ES_CORE_RENDERER_RENDERER_H
@@ -13,6 +13,13 @@ namespace Renderer
 {
 	static SDL_GLContext sdlContext = nullptr;
 
+	// GL state cache : blending and the client arrays stay enabled, the rest is only changed when it differs
+	static unsigned int boundTexture   = 0;
+	static bool         textureEnabled = false;
+	static GLenum       blendSrc       = GL_ONE;
+	static GLenum       blendDst       = GL_ZERO;
+	static Rect         scissorRect    = Rect(0, 0, 0, 0);
+
 	static GLenum convertBlendFactor(const Blend::Factor _blendFactor)
 	{
 		switch(_blendFactor)
@@ -43,15 +50,35 @@ namespace Renderer
 
 	} // convertTextureType
 
+	static void setBlendFunc(const Blend::Factor _srcBlendFactor, const Blend::Factor _dstBlendFactor)
+	{
+		const GLenum src = convertBlendFactor(_srcBlendFactor);
+		const GLenum dst = convertBlendFactor(_dstBlendFactor);
+
+		if((src == blendSrc) && (dst == blendDst))
+			return;
+
+		glBlendFunc(src, dst);
+		blendSrc = src;
+		blendDst = dst;
+
+	} // setBlendFunc
+
 	unsigned int convertColor(const unsigned int _color)
 	{
-		// convert from rgba to abgr
+		// convert from rgba to abgr, which is a plain byte swap
+#if defined(__GNUC__)
+		return __builtin_bswap32(_color);
+#elif defined(_MSC_VER)
+		return _byteswap_ulong(_color);
+#else
 		unsigned char r = ((_color & 0xff000000) >> 24) & 255;
 		unsigned char g = ((_color & 0x00ff0000) >> 16) & 255;
 		unsigned char b = ((_color & 0x0000ff00) >>  8) & 255;
 		unsigned char a = ((_color & 0x000000ff)      ) & 255;
 
 		return ((a << 24) | (b << 16) | (g << 8) | (r));
+#endif
 
 	} // convertColor
 
@@ -86,6 +113,20 @@ namespace Renderer
 
 		glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
 
+		// every draw call blends and uses the same client arrays, enable them once
+		glEnable(GL_BLEND);
+		glEnableClientState(GL_VERTEX_ARRAY);
+		glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+		glEnableClientState(GL_COLOR_ARRAY);
+		glMatrixMode(GL_MODELVIEW);
+
+		// a new context starts with the default GL state
+		boundTexture   = 0;
+		textureEnabled = false;
+		blendSrc       = GL_ONE;
+		blendDst       = GL_ZERO;
+		scissorRect    = Rect(0, 0, 0, 0);
+
 		std::string glExts = (const char*)glGetString(GL_EXTENSIONS);
 		LOG(LogInfo) << "Checking available OpenGL extensions...";
 		LOG(LogInfo) << " ARB_texture_non_power_of_two: " << (glExts.find("ARB_texture_non_power_of_two") != std::string::npos ? "ok" : "MISSING");
@@ -124,6 +165,10 @@ namespace Renderer
 
 	void destroyTexture(const unsigned int _texture)
 	{
+		// GL falls back to texture 0 when the bound texture is deleted
+		if(_texture == boundTexture)
+			boundTexture = 0;
+
 		glDeleteTextures(1, &_texture);
 
 	} // destroyTexture
@@ -144,23 +189,38 @@ namespace Renderer
 
 	} // updateTexture
 
+	void copyToTexture(const unsigned int _texture, const int _x, const int _y, const unsigned int _width, const unsigned int _height)
+	{
+		bindTexture(_texture);
+
+		// glCopyTexSubImage2D starts at the bottom left of the window, the texture is upside down
+		glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, _x, getWindowHeight() - _y - _height, _width, _height);
+
+		bindTexture(0);
+
+	} // copyToTexture
+
 	void bindTexture(const unsigned int _texture)
 	{
-		glBindTexture(GL_TEXTURE_2D, _texture);
+		if(_texture != boundTexture)
+		{
+			glBindTexture(GL_TEXTURE_2D, _texture);
+			boundTexture = _texture;
+		}
 
-		if(_texture == 0) glDisable(GL_TEXTURE_2D);
-		else              glEnable(GL_TEXTURE_2D);
+		if(textureEnabled != (_texture != 0))
+		{
+			if(_texture == 0) glDisable(GL_TEXTURE_2D);
+			else              glEnable(GL_TEXTURE_2D);
+
+			textureEnabled = (_texture != 0);
+		}
 
 	} // bindTexture
 
 	void drawLines(const Vertex* _vertices, const unsigned int _numVertices, const Blend::Factor _srcBlendFactor, const Blend::Factor _dstBlendFactor)
 	{
-		glEnable(GL_BLEND);
-		glBlendFunc(convertBlendFactor(_srcBlendFactor), convertBlendFactor(_dstBlendFactor));
-
-		glEnableClientState(GL_VERTEX_ARRAY);
-		glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-		glEnableClientState(GL_COLOR_ARRAY);
+		setBlendFunc(_srcBlendFactor, _dstBlendFactor);
 
 		glVertexPointer(  2, GL_FLOAT,         sizeof(Vertex), &_vertices[0].pos);
 		glTexCoordPointer(2, GL_FLOAT,         sizeof(Vertex), &_vertices[0].tex);
@@ -168,22 +228,11 @@ namespace Renderer
 
 		glDrawArrays(GL_LINES, 0, _numVertices);
 
-		glDisableClientState(GL_COLOR_ARRAY);
-		glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-		glDisableClientState(GL_VERTEX_ARRAY);
-
-		glDisable(GL_BLEND);
-
 	} // drawLines
 
 	void drawTriangleStrips(const Vertex* _vertices, const unsigned int _numVertices, const Blend::Factor _srcBlendFactor, const Blend::Factor _dstBlendFactor)
 	{
-		glEnable(GL_BLEND);
-		glBlendFunc(convertBlendFactor(_srcBlendFactor), convertBlendFactor(_dstBlendFactor));
-
-		glEnableClientState(GL_VERTEX_ARRAY);
-		glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-		glEnableClientState(GL_COLOR_ARRAY);
+		setBlendFunc(_srcBlendFactor, _dstBlendFactor);
 
 		glVertexPointer(  2, GL_FLOAT,         sizeof(Vertex), &_vertices[0].pos);
 		glTexCoordPointer(2, GL_FLOAT,         sizeof(Vertex), &_vertices[0].tex);
@@ -191,18 +240,13 @@ namespace Renderer
 
 		glDrawArrays(GL_TRIANGLE_STRIP, 0, _numVertices);
 
-		glDisableClientState(GL_COLOR_ARRAY);
-		glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-		glDisableClientState(GL_VERTEX_ARRAY);
-
-		glDisable(GL_BLEND);
-
 	} // drawTriangleStrips
 
 	void setProjection(const Transform4x4f& _projection)
 	{
 		glMatrixMode(GL_PROJECTION);
 		glLoadMatrixf((GLfloat*)&_projection);
+		glMatrixMode(GL_MODELVIEW);
 
 	} // setProjection
 
@@ -210,7 +254,6 @@ namespace Renderer
 	{
 		Transform4x4f matrix = _matrix;
 		matrix.round();
-		glMatrixMode(GL_MODELVIEW);
 		glLoadMatrixf((GLfloat*)&matrix);
 
 	} // setMatrix
@@ -224,6 +267,9 @@ namespace Renderer
 
 	void setScissor(const Rect& _scissor)
 	{
+		if((_scissor.x == scissorRect.x) && (_scissor.y == scissorRect.y) && (_scissor.w == scissorRect.w) && (_scissor.h == scissorRect.h))
+			return;
+
 		if((_scissor.x == 0) && (_scissor.y == 0) && (_scissor.w == 0) && (_scissor.h == 0))
 		{
 			glDisable(GL_SCISSOR_TEST);
@@ -232,9 +278,13 @@ namespace Renderer
 		{
 			// glScissor starts at the bottom left of the window
 			glScissor(_scissor.x, getWindowHeight() - _scissor.y - _scissor.h, _scissor.w, _scissor.h);
-			glEnable(GL_SCISSOR_TEST);
+
+			if((scissorRect.w == 0) && (scissorRect.h == 0))
+				glEnable(GL_SCISSOR_TEST);
 		}
 
+		scissorRect = _scissor;
+
 	} // setScissor
 
 	void setSwapInterval()
@@ -323,12 +373,7 @@ namespace Renderer
 
 		glEnable(GL_MULTISAMPLE);
 
-		glEnable(GL_BLEND);
-		glBlendFunc(convertBlendFactor(_srcBlendFactor), convertBlendFactor(_dstBlendFactor));
-
-		glEnableClientState(GL_VERTEX_ARRAY);
-		glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-		glEnableClientState(GL_COLOR_ARRAY);
+		setBlendFunc(_srcBlendFactor, _dstBlendFactor);
 
 		glVertexPointer(2, GL_FLOAT, sizeof(Vertex), &vxs[0].pos);
 		glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), &vxs[0].tex);
@@ -336,20 +381,14 @@ namespace Renderer
 
 		glDrawArrays(GL_TRIANGLE_FAN, 0, vertex.size());
 
-		glDisableClientState(GL_COLOR_ARRAY);
-		glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-		glDisableClientState(GL_VERTEX_ARRAY);
-
 		delete[] vxs;
 
-		glDisable(GL_BLEND);
 		glDisable(GL_MULTISAMPLE);
 	}
 
 	void enableRoundCornerStencil(float x, float y, float width, float height, float radius)
 	{
-		bool tx = glIsEnabled(GL_TEXTURE_2D);
-		glDisable(GL_TEXTURE_2D);
+		unsigned int texture = boundTexture;
 
 		glClear(GL_DEPTH_BUFFER_BIT);
 		glEnable(GL_STENCIL_TEST);
@@ -369,8 +408,7 @@ namespace Renderer
 		glStencilFunc(GL_EQUAL, 0, 0xFF);
 		glStencilFunc(GL_EQUAL, 1, 0xFF);
 
-		if (tx)
-			glEnable(GL_TEXTURE_2D);
+		bindTexture(texture);
 	}
 
 	void disableStencil()
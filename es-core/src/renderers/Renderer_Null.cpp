@@ -0,0 +1,176 @@
+#if defined(USE_NULL_RENDERER)
+
+#include "renderers/Renderer.h"
+#include "math/Transform4x4f.h"
+#include "Log.h"
+
+#include <SDL.h>
+
+namespace Renderer
+{
+	static Statistics   statistics     = { 0, 0, 0, 0, 0, 0 };
+	static unsigned int lastTextureId  = 0;
+
+	static size_t getTextureSize(const Texture::Type _type, const unsigned int _width, const unsigned int _height)
+	{
+		return (size_t)_width * (size_t)_height * (_type == Texture::RGBA ? 4 : 1);
+
+	} // getTextureSize
+
+	const Statistics& getStatistics()
+	{
+		return statistics;
+
+	} // getStatistics
+
+	void resetStatistics()
+	{
+		// live textures are not reset, they are still allocated
+		unsigned int textures = statistics.textures;
+		statistics = { 0, 0, 0, 0, 0, textures };
+
+	} // resetStatistics
+
+	unsigned int convertColor(const unsigned int _color)
+	{
+		// convert from rgba to abgr, like the GL backends
+#if defined(__GNUC__)
+		return __builtin_bswap32(_color);
+#elif defined(_MSC_VER)
+		return _byteswap_ulong(_color);
+#else
+		unsigned char r = ((_color & 0xff000000) >> 24) & 255;
+		unsigned char g = ((_color & 0x00ff0000) >> 16) & 255;
+		unsigned char b = ((_color & 0x0000ff00) >>  8) & 255;
+		unsigned char a = ((_color & 0x000000ff)      ) & 255;
+
+		return ((a << 24) | (b << 16) | (g << 8) | (r));
+#endif
+
+	} // convertColor
+
+	unsigned int getWindowFlags()
+	{
+		return SDL_WINDOW_HIDDEN;
+
+	} // getWindowFlags
+
+	void setupWindow()
+	{
+
+	} // setupWindow
+
+	void createContext()
+	{
+		LOG(LogInfo) << "Using null renderer, nothing will be displayed";
+
+	} // createContext
+
+	void destroyContext()
+	{
+
+	} // destroyContext
+
+	unsigned int createTexture(const Texture::Type _type, const bool _linear, const bool _repeat, const unsigned int _width, const unsigned int _height, void* _data)
+	{
+		statistics.textures++;
+
+		if (_data != nullptr)
+		{
+			statistics.textureUploads++;
+			statistics.textureBytes += getTextureSize(_type, _width, _height);
+		}
+
+		return ++lastTextureId;
+
+	} // createTexture
+
+	void destroyTexture(const unsigned int _texture)
+	{
+		if (_texture != 0 && statistics.textures > 0)
+			statistics.textures--;
+
+	} // destroyTexture
+
+	void updateTexture(const unsigned int _texture, const Texture::Type _type, const unsigned int _x, const unsigned _y, const unsigned int _width, const unsigned int _height, void* _data)
+	{
+		statistics.textureUploads++;
+		statistics.textureBytes += getTextureSize(_type, _width, _height);
+
+	} // updateTexture
+
+	void copyToTexture(const unsigned int _texture, const int _x, const int _y, const unsigned int _width, const unsigned int _height)
+	{
+
+	} // copyToTexture
+
+	void bindTexture(const unsigned int _texture)
+	{
+
+	} // bindTexture
+
+	void drawLines(const Vertex* _vertices, const unsigned int _numVertices, const Blend::Factor _srcBlendFactor, const Blend::Factor _dstBlendFactor)
+	{
+		statistics.drawCalls++;
+		statistics.vertices += _numVertices;
+
+	} // drawLines
+
+	void drawTriangleStrips(const Vertex* _vertices, const unsigned int _numVertices, const Blend::Factor _srcBlendFactor, const Blend::Factor _dstBlendFactor)
+	{
+		statistics.drawCalls++;
+		statistics.vertices += _numVertices;
+
+	} // drawTriangleStrips
+
+	void setProjection(const Transform4x4f& _projection)
+	{
+
+	} // setProjection
+
+	void setMatrix(const Transform4x4f& _matrix)
+	{
+
+	} // setMatrix
+
+	void setViewport(const Rect& _viewport)
+	{
+
+	} // setViewport
+
+	void setScissor(const Rect& _scissor)
+	{
+
+	} // setScissor
+
+	void setSwapInterval()
+	{
+
+	} // setSwapInterval
+
+	void swapBuffers()
+	{
+		statistics.frames++;
+
+	} // swapBuffers
+
+	void drawRoundRect(float x, float y, float width, float height, float radius, unsigned int color, const Blend::Factor _srcBlendFactor, const Blend::Factor _dstBlendFactor)
+	{
+		statistics.drawCalls++;
+
+	} // drawRoundRect
+
+	void enableRoundCornerStencil(float x, float y, float width, float height, float radius)
+	{
+		statistics.drawCalls++;
+
+	} // enableRoundCornerStencil
+
+	void disableStencil()
+	{
+
+	} // disableStencil
+
+} // Renderer::
+
+#endif // USE_NULL_RENDERER
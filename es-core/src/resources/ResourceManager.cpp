@@ -1,11 +1,198 @@
 #include "ResourceManager.h"
 
 #include "utils/FileSystemUtil.h"
-#include <fstream>
+#include "Log.h"
+#include <algorithm>
+#include <mutex>
+#include <string.h>
+#include <vector>
+
+#if !WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 auto array_deleter = [](unsigned char* p) { delete[] p; };
 auto nop_deleter = [](unsigned char* /*p*/) { };
 
+// Bundled resources can be packed into a single archive, looked up when a resource doesn't exist as a file.
+//
+// Layout : header, entries sorted by name (strcmp), string table of the names, then the file contents, each aligned
+// on 16 bytes. All offsets are from the start of the archive, which is mapped once and shared by every view into it.
+#define RESOURCE_PACK_MAGIC   0x4B505345 // "ESPK"
+#define RESOURCE_PACK_VERSION 1
+#define RESOURCE_PACK_NAME    "resources.pak"
+
+struct ResourcePackHeader
+{
+	unsigned int magic;
+	unsigned int version;
+	unsigned int entryCount;
+	unsigned int dataSize;
+};
+
+struct ResourcePackEntry
+{
+	unsigned int nameOffset;
+	unsigned int dataOffset;
+	unsigned int dataSize;
+};
+
+static std::mutex sPackLock;
+static bool sPackOpened = false;
+static std::shared_ptr<unsigned char> sPackData;
+static size_t sPackSize = 0;
+
+// Reads a whole file in a heap buffer
+static ResourceData readFile(const std::string& path)
+{
+	ResourceData empty = { nullptr, 0 };
+
+	FILE* file = fopen(path.c_str(), "rb");
+	if (file == nullptr)
+		return empty;
+
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	if (size <= 0)
+	{
+		fclose(file);
+		return empty;
+	}
+
+	std::shared_ptr<unsigned char> data(new unsigned char[size], array_deleter);
+	size_t read = fread(data.get(), 1, size, file);
+	fclose(file);
+
+	if (read != (size_t)size)
+		return empty;
+
+	ResourceData ret = { data, (size_t)size };
+	return ret;
+}
+
+// Maps a whole file read-only. The mapping lives as long as a copy of the returned pointer does.
+// Only for files which are never rewritten while in use : reading a mapping truncated by another writer raises SIGBUS
+static ResourceData mapFile(const std::string& path)
+{
+#if WIN32
+	return readFile(path);
+#else
+	ResourceData empty = { nullptr, 0 };
+
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return empty;
+
+	struct stat info;
+	if (fstat(fd, &info) != 0 || info.st_size <= 0)
+	{
+		close(fd);
+		return empty;
+	}
+
+	size_t size = (size_t)info.st_size;
+	void* map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (map == MAP_FAILED)
+		return empty;
+
+	std::shared_ptr<unsigned char> data((unsigned char*)map, [size](unsigned char* p) { munmap(p, size); });
+
+	ResourceData ret = { data, size };
+	return ret;
+#endif
+}
+
+static ResourceData getResourcePack()
+{
+	std::unique_lock<std::mutex> lock(sPackLock);
+	if (sPackOpened)
+	{
+		ResourceData ret = { sPackData, sPackSize };
+		return ret;
+	}
+
+	sPackOpened = true;
+
+	std::string paths[] = {
+		Utils::FileSystem::getHomePath() + "/.emulationstation/" RESOURCE_PACK_NAME,
+		Utils::FileSystem::getExePath() + "/" RESOURCE_PACK_NAME,
+		Utils::FileSystem::getCWDPath() + "/" RESOURCE_PACK_NAME
+	};
+
+	for (auto path : paths)
+	{
+		if (!Utils::FileSystem::exists(path))
+			continue;
+
+		ResourceData pack = mapFile(path);
+		if (pack.length < sizeof(ResourcePackHeader))
+			continue;
+
+		const ResourcePackHeader* header = (const ResourcePackHeader*)pack.ptr.get();
+		if (header->magic != RESOURCE_PACK_MAGIC || header->version != RESOURCE_PACK_VERSION || header->dataSize != pack.length ||
+			sizeof(ResourcePackHeader) + (size_t)header->entryCount * sizeof(ResourcePackEntry) > pack.length)
+		{
+			LOG(LogWarning) << "Ignoring invalid resource archive " << path;
+			continue;
+		}
+
+		const ResourcePackEntry* entries = (const ResourcePackEntry*)(header + 1);
+		bool valid = true;
+
+		for (unsigned int i = 0; i < header->entryCount && valid; i++)
+			if (entries[i].nameOffset >= pack.length || (size_t)entries[i].dataOffset + entries[i].dataSize > pack.length ||
+				memchr(pack.ptr.get() + entries[i].nameOffset, 0, pack.length - entries[i].nameOffset) == nullptr)
+				valid = false;
+
+		if (!valid)
+		{
+			LOG(LogWarning) << "Ignoring invalid resource archive " << path;
+			continue;
+		}
+
+		LOG(LogInfo) << "Using resource archive " << path << " (" << header->entryCount << " files)";
+		sPackData = pack.ptr;
+		sPackSize = pack.length;
+		break;
+	}
+
+	ResourceData ret = { sPackData, sPackSize };
+	return ret;
+}
+
+// Returns a view into the mapped archive, sharing its lifetime, or an empty ResourceData
+static ResourceData findPackedResource(const std::string& path)
+{
+	ResourceData empty = { nullptr, 0 };
+
+	if (path.size() < 3 || path[0] != ':' || path[1] != '/')
+		return empty;
+
+	ResourceData pack = getResourcePack();
+	if (pack.ptr == nullptr)
+		return empty;
+
+	const char* base = (const char*)pack.ptr.get();
+	const ResourcePackHeader* header = (const ResourcePackHeader*)base;
+	const ResourcePackEntry* entries = (const ResourcePackEntry*)(header + 1);
+	const char* name = path.c_str() + 2;
+
+	const ResourcePackEntry* entry = std::lower_bound(entries, entries + header->entryCount, name, [base](const ResourcePackEntry& e, const char* n) { return strcmp(base + e.nameOffset, n) < 0; });
+	if (entry == entries + header->entryCount || strcmp(base + entry->nameOffset, name) != 0 || entry->dataSize == 0)
+		return empty;
+
+	// aliasing constructor : the view keeps the whole mapping alive
+	ResourceData ret = { std::shared_ptr<unsigned char>(pack.ptr, pack.ptr.get() + entry->dataOffset), entry->dataSize };
+	return ret;
+}
+
 std::shared_ptr<ResourceManager> ResourceManager::sInstance = nullptr;
 
 ResourceManager::ResourceManager()
@@ -52,45 +239,135 @@ const ResourceData ResourceManager::getFileData(const std::string& path) const
 	//check if its a resource
 	const std::string respath = getResourcePath(path);
 
-	auto size = Utils::FileSystem::getFileSize(respath);
-	if (size > 0)
-	{
-		ResourceData data = loadFile(respath, size);
+	// bundled resources are mapped read-only and decoders consume the mapping without any copy. Game media, themes
+	// and the resources overridden in the home folder can be rewritten while in use (scraper, theme updates) : read them
+	bool bundled = (respath != path && respath.find(Utils::FileSystem::getHomePath() + "/.emulationstation/") != 0);
+
+	ResourceData data = bundled ? mapFile(respath) : readFile(respath);
+	if (data.ptr != nullptr)
 		return data;
-	}
+
+	// a bundled resource which isn't a file : look in the resource archive
+	if (respath == path)
+		return findPackedResource(path);
 
 	//if the file doesn't exist, return an "empty" ResourceData
-	ResourceData data = {NULL, 0};
 	return data;
 }
 
-ResourceData ResourceManager::loadFile(const std::string& path, size_t size) const
+bool ResourceManager::fileExists(const std::string& path) const
 {
-	std::ifstream stream(path, std::ios::binary);
+	//if it exists as a resource file, return true
+	if(getResourcePath(path) != path)
+		return true;
+
+	if(Utils::FileSystem::exists(path))
+		return true;
 
-	if (size == 0)
+	return findPackedResource(path).ptr != nullptr;
+}
+
+bool ResourceManager::packResources(const std::string& directory, const std::string& archivePath)
+{
+	std::string root = Utils::FileSystem::getGenericPath(directory);
+	if (!Utils::FileSystem::isDirectory(root))
 	{
-		stream.seekg(0, stream.end);
-		size = (size_t)stream.tellg();
-		stream.seekg(0, stream.beg);
+		LOG(LogError) << "Can't pack resources, " << root << " is not a directory";
+		return false;
 	}
 
-	//supply custom deleter to properly free array
-	std::shared_ptr<unsigned char> data(new unsigned char[size], array_deleter);
-	stream.read((char*)data.get(), size);
-	stream.close();
+	std::vector<std::string> names;
+	for (auto file : Utils::FileSystem::getDirContent(root, true))
+	{
+		if (!Utils::FileSystem::isRegularFile(file))
+			continue;
 
-	ResourceData ret = {data, size};
-	return ret;
-}
+		bool contains = false;
+		std::string name = Utils::FileSystem::removeCommonPath(file, root, contains);
+		if (contains && !name.empty())
+			names.push_back(name);
+	}
 
-bool ResourceManager::fileExists(const std::string& path) const
-{
-	//if it exists as a resource file, return true
-	if(getResourcePath(path) != path)
-		return true;
+	std::sort(names.begin(), names.end(), [](const std::string& a, const std::string& b) { return strcmp(a.c_str(), b.c_str()) < 0; });
+
+	std::vector<ResourcePackEntry> entries(names.size());
+	std::vector<char> strings;
+	for (size_t i = 0; i < names.size(); i++)
+	{
+		entries[i].nameOffset = (unsigned int)strings.size();
+		strings.insert(strings.end(), names[i].c_str(), names[i].c_str() + names[i].size() + 1);
+	}
+
+	size_t stringsOffset = sizeof(ResourcePackHeader) + entries.size() * sizeof(ResourcePackEntry);
+	size_t offset = (stringsOffset + strings.size() + 15) & ~(size_t)15;
+
+	std::vector<ResourceData> contents;
+	contents.reserve(names.size());
+
+	for (size_t i = 0; i < names.size(); i++)
+	{
+		contents.push_back(mapFile(root + "/" + names[i]));
+
+		entries[i].nameOffset += (unsigned int)stringsOffset;
+		entries[i].dataOffset = (unsigned int)offset;
+		entries[i].dataSize = (unsigned int)contents[i].length;
+
+		offset = (offset + contents[i].length + 15) & ~(size_t)15;
+	}
+
+	if (offset > 0xFFFFFFFF)
+	{
+		LOG(LogError) << "Can't pack resources, the archive would exceed 4 GB";
+		return false;
+	}
+
+	ResourcePackHeader header;
+	header.magic = RESOURCE_PACK_MAGIC;
+	header.version = RESOURCE_PACK_VERSION;
+	header.entryCount = (unsigned int)entries.size();
+	header.dataSize = (unsigned int)offset;
+
+	std::string tmpPath = archivePath + ".tmp";
+
+	FILE* file = fopen(tmpPath.c_str(), "wb");
+	if (file == nullptr)
+	{
+		LOG(LogError) << "Can't write resource archive " << archivePath;
+		return false;
+	}
+
+	static const char padding[16] = { 0 };
+
+	bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+	ok = ok && (entries.empty() || fwrite(entries.data(), sizeof(ResourcePackEntry), entries.size(), file) == entries.size());
+	ok = ok && (strings.empty() || fwrite(strings.data(), 1, strings.size(), file) == strings.size());
+
+	size_t written = stringsOffset + strings.size();
+	for (size_t i = 0; i < contents.size() && ok; i++)
+	{
+		ok = fwrite(padding, 1, entries[i].dataOffset - written, file) == entries[i].dataOffset - written;
+		ok = ok && (contents[i].length == 0 || fwrite(contents[i].ptr.get(), 1, contents[i].length, file) == contents[i].length);
+		written = entries[i].dataOffset + contents[i].length;
+	}
+
+	ok = ok && fwrite(padding, 1, offset - written, file) == offset - written;
+	ok = (fclose(file) == 0) && ok;
+
+	if (ok)
+	{
+		Utils::FileSystem::removeFile(archivePath);
+		ok = rename(tmpPath.c_str(), archivePath.c_str()) == 0;
+	}
+
+	if (!ok)
+	{
+		Utils::FileSystem::removeFile(tmpPath);
+		LOG(LogError) << "Can't write resource archive " << archivePath;
+		return false;
+	}
 
-	return Utils::FileSystem::exists(path);
+	LOG(LogInfo) << "Packed " << names.size() << " resources into " << archivePath;
+	return true;
 }
 
 #include "resources/TextureResource.h"
@@ -8,6 +8,13 @@
 //The ResourceManager exists to...
 //Allow loading resources embedded into the executable like an actual file.
 //Allow embedded resources to be optionally remapped to actual files for further customization.
+//Allow bundled resources to be packed into a single archive file.
+//Packed resources are only reachable through getFileData and fileExists : getResourcePath returns them unmodified.
+//
+//ResourceData is a read-only view of the file, mapped in memory for bundled resources : keep a copy as long as the data is used.
+//Only the bundled resources and the archive are mapped. Theme files, game media and resources overridden in the home folder
+//can be rewritten while in use, they are read into a heap buffer : theme images, fonts and sounds are still copied once.
+//Sounds are copied again anyway when SDL_mixer decodes them into its chunk.
 
 struct ResourceData
 {
@@ -39,13 +46,13 @@ public:
 	const ResourceData getFileData(const std::string& path) const;
 	bool fileExists(const std::string& path) const;
 
+	static bool packResources(const std::string& directory, const std::string& archivePath);
+
 private:
 	ResourceManager();
 
 	static std::shared_ptr<ResourceManager> sInstance;
 
-	ResourceData loadFile(const std::string& path, size_t size) const;
-
 	class ReloadableInfo
 	{
 	public:
@@ -8,13 +8,15 @@
 #include <nanosvg/nanosvg.h>
 #include <nanosvg/nanosvgrast.h>
 #include <assert.h>
+#include <map>
 #include <string.h>
 
 #define DPI 96
 
 bool TextureData::OPTIMIZEVRAM = false;
+bool TextureData::RESUMECACHE = false;
 
-TextureData::TextureData(bool tile) : mTile(tile), mTextureID(0), mDataRGBA(nullptr), mScalable(false),
+TextureData::TextureData(bool tile) : mTile(tile), mTextureID(0), mLastUse(0), mLastFrame(0), mDataRGBA(nullptr), mResumeRGBA(nullptr), mScalable(false),
 									  mWidth(0), mHeight(0), mSourceWidth(0.0f), mSourceHeight(0.0f), mMaxSize(MaxSizeInfo()), mPackedSize(Vector2i(0,0)), mBaseSize(Vector2i(0, 0))
 {
 	mIsExternalDataRGBA = false;
@@ -34,12 +36,20 @@ void TextureData::initFromPath(const std::string& path)
 	mReloadable = true;
 }
 
-bool TextureData::initSVGFromMemory(const unsigned char* fileData, size_t length)
+// Parsed SVG documents, by path. Rasterising at another size doesn't need to parse the file again
+#define MAX_PARSED_SVG 128
+
+static std::mutex sSVGCacheLock;
+static std::map<std::string, std::shared_ptr<NSVGimage>> sSVGCache;
+
+static std::shared_ptr<NSVGimage> parseSVG(const std::string& path, const unsigned char* fileData, size_t length)
 {
-	// If already initialised then don't read again
-	std::unique_lock<std::mutex> lock(mMutex);
-	if (mDataRGBA)
-		return true;
+	{
+		std::unique_lock<std::mutex> lock(sSVGCacheLock);
+		auto it = sSVGCache.find(path);
+		if (it != sSVGCache.cend())
+			return it->second;
+	}
 
 	// nsvgParse excepts a modifiable, null-terminated string
 	char* copy = (char*)malloc(length + 1);
@@ -47,8 +57,52 @@ bool TextureData::initSVGFromMemory(const unsigned char* fileData, size_t length
 	memcpy(copy, fileData, length);
 	copy[length] = '\0';
 
-	NSVGimage* svgImage = nsvgParse(copy, "px", DPI);
+	NSVGimage* image = nsvgParse(copy, "px", DPI);
 	free(copy);
+	if (!image)
+		return nullptr;
+
+	std::shared_ptr<NSVGimage> svgImage(image, nsvgDelete);
+
+	if (!path.empty())
+	{
+		std::unique_lock<std::mutex> lock(sSVGCacheLock);
+		if (sSVGCache.size() >= MAX_PARSED_SVG)
+			sSVGCache.clear();
+
+		sSVGCache[path] = svgImage;
+	}
+
+	return svgImage;
+}
+
+void TextureData::clearSVGCache()
+{
+	std::unique_lock<std::mutex> lock(sSVGCacheLock);
+	sSVGCache.clear();
+}
+
+// Rounds a raster size up to 1/8th of its power of two, so small zoom changes reuse the same raster
+static int quantizeRasterSize(int size)
+{
+	int step = 16;
+	while (step * 16 <= size)
+		step *= 2;
+
+	return ((size + step - 1) / step) * step;
+}
+
+bool TextureData::initSVGFromMemory(const unsigned char* fileData, size_t length)
+{
+	// If already initialised then don't read again
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		if (mDataRGBA)
+			return true;
+	}
+
+	// Rasterising is done without holding the lock : when resizing, the current texture can still be drawn meanwhile
+	std::shared_ptr<NSVGimage> svgImage = parseSVG(mPath, fileData, length);
 	if (!svgImage)
 	{
 		LOG(LogError) << "Error parsing SVG image.";
@@ -60,61 +114,79 @@ bool TextureData::initSVGFromMemory(const unsigned char* fileData, size_t length
 
 	// We want to rasterise this texture at a specific resolution. If the source size
 	// variables are set then use them otherwise set them from the parsed file
-	if ((mSourceWidth == 0.0f) && (mSourceHeight == 0.0f))
+	float sourceWidth = mSourceWidth;
+	float sourceHeight = mSourceHeight;
+
+	if ((sourceWidth == 0.0f) && (sourceHeight == 0.0f))
 	{
-		mSourceWidth = svgImage->width;
-		mSourceHeight = svgImage->height;
+		sourceWidth = svgImage->width;
+		sourceHeight = svgImage->height;
 	}
 	else 
-		mSourceWidth = (mSourceHeight * svgImage->width) / svgImage->height; // FCATMP : Always keep source aspect ratio
+		sourceWidth = (sourceHeight * svgImage->width) / svgImage->height; // FCATMP : Always keep source aspect ratio
 
-	mWidth = (size_t)Math::round(mSourceWidth);
-	mHeight = (size_t)Math::round(mSourceHeight);
+	size_t width = (size_t)Math::round(sourceWidth);
+	size_t height = (size_t)Math::round(sourceHeight);
 
-	if (mWidth == 0)
+	if (width == 0)
 	{
 		// auto scale width to keep aspect
-		mWidth = (size_t)Math::round(((float)mHeight / svgImage->height) * svgImage->width);
+		width = (size_t)Math::round(((float)height / svgImage->height) * svgImage->width);
 	}
-	else if (mHeight == 0)
+	else if (height == 0)
 	{
 		// auto scale height to keep aspect
-		mHeight = (size_t)Math::round(((float)mWidth / svgImage->width) * svgImage->height);
+		height = (size_t)Math::round(((float)width / svgImage->width) * svgImage->height);
 	}
 
-	mBaseSize = Vector2i(mWidth, mHeight);
-	
-	if (mMaxSize.x() > 0 && mMaxSize.y() > 0 && mHeight < mMaxSize.y() && mWidth < mMaxSize.x()) // FCATMP
+	Vector2i baseSize = Vector2i(width, height);
+	Vector2i packedSize = Vector2i(0, 0);
+
+	if (mMaxSize.x() > 0 && mMaxSize.y() > 0 && height < mMaxSize.y() && width < mMaxSize.x()) // FCATMP
 	{
-		Vector2i sz = ImageIO::adjustPictureSize(Vector2i(mWidth, mHeight), Vector2i(mMaxSize.x(), mMaxSize.y()), mMaxSize.externalZoom());
-		mHeight = sz.y();
-		mWidth = (int)((mHeight * svgImage->width) / svgImage->height);
+		Vector2i sz = ImageIO::adjustPictureSize(Vector2i(width, height), Vector2i(mMaxSize.x(), mMaxSize.y()), mMaxSize.externalZoom());
+		height = sz.y();
+		width = (int)((height * svgImage->width) / svgImage->height);
 	}
 	
-	if (OPTIMIZEVRAM && mMaxSize.x() > 0 && mMaxSize.y() > 0 && (mWidth > mMaxSize.x() || mHeight > mMaxSize.y()))
+	if (OPTIMIZEVRAM && mMaxSize.x() > 0 && mMaxSize.y() > 0 && (width > mMaxSize.x() || height > mMaxSize.y()))
 	{
-		Vector2i sz = ImageIO::adjustPictureSize(Vector2i(mWidth, mHeight), Vector2i(mMaxSize.x(), mMaxSize.y()), mMaxSize.externalZoom());
-		mHeight = sz.y();	
-		mWidth = (mHeight * svgImage->width) / svgImage->height;
+		Vector2i sz = ImageIO::adjustPictureSize(Vector2i(width, height), Vector2i(mMaxSize.x(), mMaxSize.y()), mMaxSize.externalZoom());
+		height = Math::min(quantizeRasterSize(sz.y()), baseSize.y());
+		width = (height * svgImage->width) / svgImage->height;
 
-		mPackedSize = Vector2i(mWidth, mHeight);
+		packedSize = Vector2i(width, height);
 	}
-	else
-		mPackedSize = Vector2i(0, 0);
-	
-	unsigned char* dataRGBA = new unsigned char[mWidth * mHeight * 4];
 
-	double scale = ((float) ((int) mHeight)) / svgImage->height;
-	double scaleV = ((float) ((int) mWidth)) / svgImage->width;
+	if (width == 0 || height == 0)
+		return false;
+
+	unsigned char* dataRGBA = new unsigned char[width * height * 4];
+
+	double scale = ((float) ((int) height)) / svgImage->height;
+	double scaleV = ((float) ((int) width)) / svgImage->width;
 	if (scaleV < scale)
 		scale = scaleV;
 
+	// Rasterise from the last line with a negative stride : the result is already flipped vertically
 	NSVGrasterizer* rast = nsvgCreateRasterizer();
-	nsvgRasterize(rast, svgImage, 0, 0, scale, dataRGBA, (int)mWidth, (int)mHeight, (int)mWidth * 4);
+	nsvgRasterize(rast, svgImage.get(), 0, 0, scale, dataRGBA + (height - 1) * width * 4, (int)width, (int)height, -(int)width * 4);
 	nsvgDeleteRasterizer(rast);
 
-	ImageIO::flipPixelsVert(dataRGBA, mWidth, mHeight);
+	std::unique_lock<std::mutex> lock(mMutex);
+	if (mDataRGBA)
+	{
+		// Someone else was faster
+		delete[] dataRGBA;
+		return true;
+	}
 
+	mSourceWidth = sourceWidth;
+	mSourceHeight = sourceHeight;
+	mWidth = width;
+	mHeight = height;
+	mBaseSize = baseSize;
+	mPackedSize = packedSize;
 	mDataRGBA = dataRGBA;
 
 	return true;
@@ -241,20 +313,29 @@ bool TextureData::initFromRGBAEx(unsigned char* dataRGBA, size_t width, size_t h
 
 bool TextureData::initFromExternalRGBA(unsigned char* dataRGBA, size_t width, size_t height)
 {
-	// If already initialised then don't read again
 	std::unique_lock<std::mutex> lock(mMutex);
 
 	if (!mIsExternalDataRGBA && mDataRGBA != nullptr)
 		delete[] mDataRGBA;
 
 	mIsExternalDataRGBA = true;
-	mDataRGBA = dataRGBA;
+	mDataRGBA = nullptr;
+
+	// Streamed frames are uploaded right away, while the caller still owns the pixels.
+	// The texture is allocated once, following frames of the same size only update its content.
+	if (mTextureID != 0 && mWidth == width && mHeight == height)
+		Renderer::updateTexture(mTextureID, Renderer::Texture::RGBA, 0, 0, width, height, dataRGBA);
+	else
+	{
+		if (mTextureID != 0)
+			Renderer::destroyTexture(mTextureID);
+
+		mTextureID = Renderer::createTexture(Renderer::Texture::RGBA, true, mTile, width, height, dataRGBA);
+	}
+
 	mWidth = width;
 	mHeight = height;
 
-	if (mTextureID != 0)
-		Renderer::updateTexture(mTextureID, Renderer::Texture::RGBA, -1, -1, mWidth, mHeight, mDataRGBA);
-
 	return true;
 }
 
@@ -296,9 +377,23 @@ bool TextureData::uploadAndBind()
 {
 	// See if it's already been uploaded
 	std::unique_lock<std::mutex> lock(mMutex);
+
+	// Data loaded while a texture exists is a new raster for another size : replace the texture
+	if (mTextureID != 0 && mDataRGBA != nullptr && !mIsExternalDataRGBA)
+	{
+		Renderer::destroyTexture(mTextureID);
+		mTextureID = 0;
+	}
+
 	if (mTextureID != 0)
 	{
 		Renderer::bindTexture(mTextureID);
+
+		if (mResumeRGBA != nullptr && !RESUMECACHE)
+		{
+			delete[] mResumeRGBA;
+			mResumeRGBA = nullptr;
+		}
 	}
 	else
 	{
@@ -314,8 +409,19 @@ bool TextureData::uploadAndBind()
 		mTextureID = Renderer::createTexture(Renderer::Texture::RGBA, true, mTile, mWidth, mHeight, mDataRGBA);
 		if (mTextureID)
 		{
+			if (mResumeRGBA != nullptr)
+				delete[] mResumeRGBA;
+
+			mResumeRGBA = nullptr;
+
+			// Only textures loaded from files are kept : the others are rebuilt by their owner
 			if (mDataRGBA != nullptr && !mIsExternalDataRGBA)
-				delete[] mDataRGBA;
+			{
+				if (RESUMECACHE && !mPath.empty())
+					mResumeRGBA = mDataRGBA;
+				else
+					delete[] mDataRGBA;
+			}
 
 			mDataRGBA = nullptr;
 		}
@@ -334,6 +440,33 @@ void TextureData::releaseVRAM()
 	}
 }
 
+bool TextureData::releaseVRAMForResume()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	if (mTextureID == 0 || mResumeRGBA == nullptr || mDataRGBA != nullptr)
+		return false;
+
+	Renderer::destroyTexture(mTextureID);
+	mTextureID = 0;
+
+	// the next uploadAndBind uploads these pixels, and keeps them again
+	mDataRGBA = mResumeRGBA;
+	mResumeRGBA = nullptr;
+	return true;
+}
+
+size_t TextureData::releaseResumeRAM()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	if (mResumeRGBA == nullptr)
+		return 0;
+
+	delete[] mResumeRGBA;
+	mResumeRGBA = nullptr;
+
+	return mWidth * mHeight * 4;
+}
+
 void TextureData::releaseRAM()
 {
 	std::unique_lock<std::mutex> lock(mMutex);
@@ -342,6 +475,11 @@ void TextureData::releaseRAM()
 		delete[] mDataRGBA;
 
 	mDataRGBA = 0;
+
+	if (mResumeRGBA != nullptr)
+		delete[] mResumeRGBA;
+
+	mResumeRGBA = nullptr;
 }
 
 size_t TextureData::width()
@@ -403,3 +541,11 @@ size_t TextureData::getVRAMUsage()
 	else
 		return 0;
 }
+
+size_t TextureData::getResumeRAMUsage()
+{
+	if (mResumeRGBA != nullptr)
+		return mWidth * mHeight * 4;
+
+	return 0;
+}
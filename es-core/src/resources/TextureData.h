@@ -18,6 +18,10 @@ public:
 	~TextureData();
 
 	static bool OPTIMIZEVRAM;
+	static bool RESUMECACHE; // keep the decoded pixels in RAM after upload, so they're uploaded again after a game without any reload
+
+	// Drop the parsed SVG documents
+	static void clearSVGCache();
 
 	// These functions populate mDataRGBA but do not upload the texture to VRAM
 
@@ -41,6 +45,12 @@ public:
 	// Release the texture from VRAM
 	void releaseVRAM();
 
+	// Release the texture from VRAM, keeping the pixels kept by RESUMECACHE for the next upload. False if there aren't any
+	bool releaseVRAMForResume();
+
+	// Release the pixels kept by RESUMECACHE, returns the bytes freed
+	size_t releaseResumeRAM();
+
 	// Release the texture from conventional RAM
 	void releaseRAM();
 
@@ -49,6 +59,9 @@ public:
 	// Get the amount of VRAM currenty used by this texture
 	size_t getVRAMUsage();
 
+	// Get the amount of RAM used by the pixels kept by RESUMECACHE
+	size_t getResumeRAMUsage();
+
 	size_t width();
 	size_t height();
 	float sourceWidth();
@@ -63,6 +76,8 @@ public:
 
 	std::string		mPath;
 	unsigned int	mTextureID;
+	unsigned int	mLastUse; // SDL ticks of the last bind, set by the manager
+	unsigned int	mLastFrame; // rendered frame of the last bind, set by the manager
 
 	unsigned char* getDataRGBA() {
 		return mDataRGBA;
@@ -72,6 +87,7 @@ private:
 	std::mutex		mMutex;
 	bool			mTile;
 	unsigned char*	mDataRGBA;
+	unsigned char*	mResumeRGBA;
 	size_t			mWidth;
 	size_t			mHeight;
 	float			mSourceWidth;
@@ -7,7 +7,7 @@
 #include "utils/FileSystemUtil.h"
 #include <SDL_timer.h>
 
-TextureDataManager::TextureDataManager()
+TextureDataManager::TextureDataManager() : mFrameCount(0)
 {
 	unsigned char data[5 * 5 * 4];
 	mBlank = std::shared_ptr<TextureData>(new TextureData(false));
@@ -100,6 +100,8 @@ std::shared_ptr<TextureData> TextureDataManager::get(const TextureResource* key,
 	if (it != mTextureLookup.cend())
 	{
 		tex = *(*it).second;
+		tex->mLastUse = SDL_GetTicks();
+		tex->mLastFrame = mFrameCount;
 
 		if (mTextures.cbegin() != (*it).second)
 		{
@@ -154,11 +156,74 @@ size_t TextureDataManager::getCommittedSize()
 	return total;
 }
 
+#define TEXTURE_EVICTION_DELAY	1000
+#define TEXTURE_EVICTION_FRAMES	60
+
+size_t TextureDataManager::evict(size_t bytes)
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+
+	unsigned int now = SDL_GetTicks();
+	size_t freed = 0;
+
+	// mTextures is ordered by last use, the most recent first
+	for (auto it = mTextures.crbegin(); it != mTextures.crend() && freed < bytes; ++it)
+	{
+		if (now - (*it)->mLastUse < TEXTURE_EVICTION_DELAY || mFrameCount - (*it)->mLastFrame < TEXTURE_EVICTION_FRAMES)
+			break;
+
+		if ((*it)->isLoaded())
+		{
+			freed += (*it)->getVRAMUsage() + (*it)->getResumeRAMUsage();
+
+			(*it)->releaseVRAM();
+			(*it)->releaseRAM();
+		}
+
+		mLoader->remove(*it);
+	}
+
+	return freed;
+}
+
+void TextureDataManager::onFrameRendered()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	mFrameCount++;
+}
+
+size_t TextureDataManager::getResumeCacheSize()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+
+	size_t total = 0;
+	for (auto tex : mTextures)
+		total += tex->getResumeRAMUsage();
+
+	return total;
+}
+
+size_t TextureDataManager::releaseResumeCache(size_t bytes)
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+
+	size_t freed = 0;
+	for (auto it = mTextures.crbegin(); it != mTextures.crend() && freed < bytes; ++it)
+		freed += (*it)->releaseResumeRAM();
+
+	return freed;
+}
+
 size_t TextureDataManager::getQueueSize()
 {
 	return mLoader->getQueueSize();
 }
 
+bool TextureDataManager::hasPendingLoads()
+{
+	return mLoader->hasPendingLoads();
+}
+
 bool compareTextures(const std::shared_ptr<TextureData>& first, const std::shared_ptr<TextureData>& second)
 {	
 	bool isResource = first->mPath.rfind(":/") == 0;
@@ -176,12 +241,19 @@ void TextureDataManager::load(std::shared_ptr<TextureData> tex, bool block)
 	{
 		if (tex->isRequiredTextureSizeOk())
 			return;
+
+		if (!block)
+		{
+			// Keep the current texture in VRAM, it's drawn until the loader has produced the bigger one
+			tex->releaseRAM();
+			mLoader->load(tex);
+			return;
+		}
 		
 		tex->releaseVRAM();
 		tex->releaseRAM();
 
 		mLoader->remove(tex);
-		block = true; // Reload instantly or other instances will fade again
 	}
 
 	// Not loaded. Make sure there is room
@@ -283,7 +355,7 @@ void TextureLoader::threadProc()
 
 			lock.unlock();
 
-			if (textureData && !textureData->isLoaded())
+			if (textureData && (!textureData->isLoaded() || !textureData->isRequiredTextureSizeOk()))
 			{
 				textureData->load();
 				mManager->onTextureLoaded(textureData);
@@ -293,6 +365,11 @@ void TextureLoader::threadProc()
 
 				std::this_thread::yield();
 			}
+			else
+			{
+				lock.lock();
+				mProcessingTextureDataQ.remove(textureData);
+			}
 		}
 	}
 }
@@ -301,8 +378,8 @@ void TextureLoader::load(std::shared_ptr<TextureData> textureData)
 {
 	std::unique_lock<std::mutex> lock(mLoaderLock);
 
-	// Make sure it's not already loaded
-	if (textureData->isLoaded())
+	// Make sure it's not already loaded, at the required size
+	if (textureData->isLoaded() && textureData->isRequiredTextureSizeOk())
 		return;
 
 	// If is is currently loading, don't add again
@@ -347,6 +424,12 @@ size_t TextureLoader::getQueueSize()
 	return mem;
 }
 
+bool TextureLoader::hasPendingLoads()
+{
+	std::unique_lock<std::mutex> lock(mLoaderLock);
+	return !mTextureDataQ.empty() || !mProcessingTextureDataQ.empty();
+}
+
 void TextureLoader::clearQueue()
 {
 	std::unique_lock<std::mutex> lock(mLoaderLock);
@@ -26,6 +26,7 @@ public:
 	void clearQueue();
 
 	size_t getQueueSize();
+	bool hasPendingLoads(); // queued or being loaded by a thread
 
 private:	
 	void threadProc();
@@ -81,11 +82,23 @@ public:
 	// Get the total size of all load-pending textures in the queue - these will
 	// be committed to VRAM as the queue is processed
 	size_t  getQueueSize();
+	// True while textures are queued or being loaded by the loader threads
+	bool	hasPendingLoads();
 	// Load a texture, freeing resources as necessary to make space
 	void load(std::shared_ptr<TextureData> tex, bool block = false);
 
 	void clearQueue();
 
+	// Release the least recently bound textures, except those bound during the last second or the last rendered frames. Returns the bytes freed
+	size_t evict(size_t bytes);
+
+	// Counts the rendered frames : skipped idle frames don't bind anything, but what is on screen is still in use
+	void onFrameRendered();
+
+	// Size and release of the pixels kept by TextureData::RESUMECACHE, least recently bound first
+	size_t getResumeCacheSize();
+	size_t releaseResumeCache(size_t bytes);
+
 	void onTextureLoaded(std::shared_ptr<TextureData> tex);
 
 private:
@@ -95,6 +108,7 @@ private:
 	std::map<const TextureResource*, std::list<std::shared_ptr<TextureData> >::const_iterator > 	mTextureLookup;
 	std::shared_ptr<TextureData>															mBlank;
 	TextureLoader*																			mLoader;
+	unsigned int																			mFrameCount;
 };
 
 #endif // ES_CORE_RESOURCES_TEXTURE_DATA_MANAGER_H
@@ -10,6 +10,7 @@ TextureDataManager		TextureResource::sTextureDataManager;
 
 std::map< TextureResource::TextureKeyType, std::weak_ptr<TextureResource>> TextureResource::sTextureMap;
 std::set<TextureResource*> 	TextureResource::sAllTextures;
+bool						TextureResource::sResumeUnload = false;
 
 TextureResource::TextureResource(const std::string& path, bool tile, bool dynamic, bool allowAsync, MaxSizeInfo maxSize) : mTextureData(nullptr), mForceLoad(false)
 {
@@ -170,6 +171,7 @@ bool TextureResource::bind()
 void TextureResource::resetCache()
 {
 	sTextureDataManager.clearQueue();
+	TextureData::clearSVGCache();
 }
 
 void TextureResource::cancelAsync(std::shared_ptr<TextureResource> texture)
@@ -210,11 +212,7 @@ std::shared_ptr<TextureResource> TextureResource::get(const std::string& path, b
 					dt->setMaxSize(maxSize);
 
 					if (dt->isLoaded() && !dt->isRequiredTextureSizeOk())
-					{
-						dt->releaseVRAM();
-						dt->releaseRAM();
-						dt->load();
-					}
+						sTextureDataManager.load(dt, !Settings::getInstance()->getBool("ThreadedLoading"));
 				}
 			}
 
@@ -316,6 +314,49 @@ size_t TextureResource::getTotalTextureSize()
 	return total;
 }
 
+size_t TextureResource::evictUnused(size_t bytes)
+{
+	// Textures managing their own data can't be loaded again
+	return sTextureDataManager.evict(bytes);
+}
+
+void TextureResource::onFrameRendered()
+{
+	sTextureDataManager.onFrameRendered();
+}
+
+size_t TextureResource::getResumeCacheSize()
+{
+	size_t total = 0;
+	for (auto tex : sAllTextures)
+		if (tex->mTextureData != nullptr)
+			total += tex->mTextureData->getResumeRAMUsage();
+
+	total += sTextureDataManager.getResumeCacheSize();
+	return total;
+}
+
+size_t TextureResource::releaseResumeCache(size_t bytes)
+{
+	size_t freed = sTextureDataManager.releaseResumeCache(bytes);
+
+	for (auto tex : sAllTextures)
+	{
+		if (freed >= bytes)
+			break;
+
+		if (tex->mTextureData != nullptr)
+			freed += tex->mTextureData->releaseResumeRAM();
+	}
+
+	return freed;
+}
+
+bool TextureResource::hasPendingLoads()
+{
+	return sTextureDataManager.hasPendingLoads();
+}
+
 bool TextureResource::unload()
 {
 	// Release the texture's resources
@@ -327,6 +368,10 @@ bool TextureResource::unload()
 
 	if (data != nullptr && data->isLoaded())
 	{
+		// Still loaded afterwards : reload() re-uploads the kept pixels instead of reading the file again
+		if (sResumeUnload && data->releaseVRAMForResume())
+			return true;
+
 		data->releaseVRAM();
 		data->releaseRAM();
 
@@ -72,7 +72,13 @@ public:
 
 	static size_t getTotalMemUsage(); // returns an approximation of total VRAM used by textures (in bytes)
 	static size_t getTotalTextureSize(); // returns the number of bytes that would be used if all textures were in memory
+	static size_t evictUnused(size_t bytes); // releases textures not drawn recently, returns the bytes freed
+	static void onFrameRendered(); // called by the window for each frame it renders, idle frames don't age the textures
+	static size_t getResumeCacheSize(); // returns the RAM used by the pixels kept by TextureData::RESUMECACHE (in bytes)
+	static size_t releaseResumeCache(size_t bytes);
 	static void resetCache();
+	static void setResumeUnload(bool value) { sResumeUnload = value; } // unload() keeps the pixels kept by TextureData::RESUMECACHE
+	static bool hasPendingLoads(); // true while the async loader still has textures queued or loading
 
 public:
 	virtual bool unload();
@@ -96,6 +102,7 @@ private:
 	static std::map< TextureKeyType, std::weak_ptr<TextureResource> > sTextureMap; // map of textures, used to prevent duplicate textures
 	static std::map< TextureKeyType, std::shared_ptr<TextureResource> > sPermanentTextureMap; // map of textures, used to prevent duplicate textures // FCAWEAK
 	static std::set<TextureResource*> 	sAllTextures;	// Set of all textures, used for memory management
+	static bool							sResumeUnload;
 
 #if _DEBUG
 	std::string	mPath;
@@ -25,6 +25,13 @@
 #include <unistd.h>
 #include <mutex>
 #endif // _WIN32
+#if defined(__linux__)
+#include <sys/inotify.h>
+#include <poll.h>
+#include <errno.h>
+#include <thread>
+#endif
+#include <atomic>
 #include <fstream>
 #include <sstream>
 
@@ -35,6 +42,14 @@ namespace Utils
 		static std::string homePath;
 		static std::string exePath;
 		
+		// Cached stat results, sharded by path so the threads loading the systems don't fight for a single lock.
+		// Inside a FileSystemCacheActivator scope everything is cached, and a path missing from a listed directory doesn't exist.
+		// On Linux, directories listed inside the scope are watched with inotify : afterwards, their existing entries stay cached
+		// for the whole session and the watcher drops them when something changes on disk.
+		// A result is only stored if nothing was invalidated since the disk was read : otherwise a stat done before a change
+		// could overwrite its invalidation and stay in the cache.
+		#define FILECACHE_SHARDS 16
+
 		struct FileCache
 		{
 			FileCache() {}
@@ -45,11 +60,14 @@ namespace Utils
 				exists = _exists;
 				hidden = false;
 				isSymLink = false;
+				watched = false;
 			}
 
 #if WIN32			
 			FileCache(DWORD dwFileAttributes)
 			{
+				watched = false;
+
 				if (0xFFFFFFFF == dwFileAttributes)
 				{
 					directory = false;
@@ -72,6 +90,7 @@ namespace Utils
 				hidden = (getFileName(name)[0] == '.');
 				directory = (entry->d_type == 4); // DT_DIR;
 				isSymLink = (entry->d_type == 10); // DT_LNK;
+				watched = false;
 			}
 
 			FileCache(dirent* entry, bool _hidden)
@@ -80,6 +99,7 @@ namespace Utils
 				hidden = _hidden;
 				directory = (entry->d_type == 4); // DT_DIR;
 				isSymLink = (entry->d_type == 10); // DT_LNK;
+				watched = false;
 			}
 #endif
 
@@ -87,82 +107,332 @@ namespace Utils
 			bool directory;
 			bool hidden;
 			bool isSymLink;
+			bool watched; // directory marker ("path/*") of a directory watched for changes
+
+			static int fromStat64(const std::string& key, struct stat64* info);
+			static unsigned int getGeneration() { return mGeneration; }
+			static void add(const std::string& key, FileCache cache, unsigned int generation);
+			static bool watch(const std::string& path);
+			static void addDirectory(const std::string& path, bool watched, unsigned int generation);
+			static bool get(const std::string& key, FileCache& cache);
+			static void invalidate(const std::string& key);
+			static void onChanged(const std::string& path);
+			static void resetCache();
+			static void purge();
+
+			static void setEnabled(bool value) { mEnabled = value; }
+
+		private:
+			static bool lookup(const std::string& key, FileCache& cache);
+			static void store(const std::string& key, const FileCache& cache, unsigned int generation);
+			static bool isWatched(const std::string& key);
+
+			static bool mEnabled;
+			static std::atomic<unsigned int> mGeneration; // incremented by every invalidation
+		};
+
+		struct FileCacheShard
+		{
+			std::map<std::string, FileCache> entries;
+			std::mutex lock;
+		};
+
+		static FileCacheShard sFileCacheShards[FILECACHE_SHARDS];
+
+		static FileCacheShard& getFileCacheShard(const std::string& key)
+		{
+			return sFileCacheShards[std::hash<std::string>()(key) % FILECACHE_SHARDS];
+		}
+
+		static std::string getDirectoryMarker(const std::string& path)
+		{
+			return path + "/*";
+		}
+
+		bool FileCache::mEnabled = false;
+		std::atomic<unsigned int> FileCache::mGeneration(0);
+
+#if defined(__linux__)
+		// inotify watches of the listed directories
+		static std::mutex sWatchLock;
+		static std::map<int, std::string> sWatches;
+		static int sWatchFd = -1;
+		static std::thread sWatchThread;
+		static std::atomic<bool> sWatchRunning(false);
+
+		static void watchThreadProc()
+		{
+			char buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
 
-			static int fromStat64(const std::string& key, struct stat64* info)
+			while (sWatchRunning)
 			{
-				int ret = stat64(key.c_str(), info);
+				// Wake up regularly so the thread can be stopped
+				struct pollfd pfd = { sWatchFd, POLLIN, 0 };
+				int ready = poll(&pfd, 1, 250);
+				if (ready <= 0)
+				{
+					if (ready == 0 || errno == EINTR)
+						continue;
 
-				std::unique_lock<std::mutex> lock(mFileCacheMutex);
+					break;
+				}
 
-				FileCache cache(ret == 0, false);
-				if (cache.exists)
+				ssize_t length = read(sWatchFd, buffer, sizeof(buffer));
+				if (length <= 0)
 				{
-					cache.directory = S_ISDIR(info->st_mode);
-#ifndef WIN32
-					cache.isSymLink = S_ISLNK(info->st_mode);
-#endif
+					if (length < 0 && (errno == EINTR || errno == EAGAIN))
+						continue;
+
+					break;
+				}
+
+				for (char* ptr = buffer; ptr < buffer + length; ptr += sizeof(struct inotify_event) + ((struct inotify_event*)ptr)->len)
+				{
+					const struct inotify_event* event = (const struct inotify_event*)ptr;
+
+					// Events were lost, nothing can be trusted anymore
+					if (event->mask & IN_Q_OVERFLOW)
+					{
+						FileCache::resetCache();
+						continue;
+					}
+
+					std::string path;
+
+					{
+						std::unique_lock<std::mutex> lock(sWatchLock);
+
+						auto it = sWatches.find(event->wd);
+						if (it == sWatches.cend())
+							continue;
+
+						path = it->second;
+
+						if (event->mask & IN_IGNORED)
+							sWatches.erase(it);
+					}
+
+					if (event->len > 0)
+						FileCache::invalidate(path + "/" + event->name);
+
+					// The directory content is not known anymore
+					FileCache::invalidate(getDirectoryMarker(path));
+
+					if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED))
+						FileCache::invalidate(path);
 				}
+			}
+		}
 
-				mFileCache[key] = cache;
+		static bool watchDirectory(const std::string& path)
+		{
+			std::unique_lock<std::mutex> lock(sWatchLock);
 
-				return ret;
+			if (sWatchFd < 0)
+			{
+				sWatchFd = inotify_init1(IN_CLOEXEC | IN_NONBLOCK);
+				if (sWatchFd < 0)
+					return false;
+
+				sWatchRunning = true;
+				sWatchThread = std::thread(watchThreadProc);
 			}
 
-			static void add(const std::string& key, FileCache cache)
+			int wd = inotify_add_watch(sWatchFd, path.c_str(), IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR);
+			if (wd < 0)
+				return false; // most probably out of watches, the directory is only cached inside activator scopes
+
+			sWatches[wd] = path;
+			return true;
+		}
+
+		// The watcher touches the cache shards : it has to be stopped before they are destroyed at exit
+		static struct WatchThreadStopper
+		{
+			~WatchThreadStopper()
 			{
-				if (!mEnabled)
+				if (!sWatchRunning)
 					return;
 
-				std::unique_lock<std::mutex> lock(mFileCacheMutex);
-				mFileCache[key] = cache;
+				sWatchRunning = false;
+
+				if (sWatchThread.joinable())
+					sWatchThread.join();
+
+				std::unique_lock<std::mutex> lock(sWatchLock);
+				close(sWatchFd);
+				sWatchFd = -1;
+				sWatches.clear();
 			}
+		} sWatchThreadStopper;
+#else
+		static bool watchDirectory(const std::string& /*path*/)
+		{
+			return false;
+		}
+#endif
+
+		bool FileCache::lookup(const std::string& key, FileCache& cache)
+		{
+			FileCacheShard& shard = getFileCacheShard(key);
+			std::unique_lock<std::mutex> lock(shard.lock);
+
+			auto it = shard.entries.find(key);
+			if (it == shard.entries.cend())
+				return false;
+
+			cache = it->second;
+			return true;
+		}
+
+		void FileCache::store(const std::string& key, const FileCache& cache, unsigned int generation)
+		{
+			FileCacheShard& shard = getFileCacheShard(key);
+			std::unique_lock<std::mutex> lock(shard.lock);
 
-			static FileCache* get(const std::string& key)
+			if (mGeneration == generation)
+				shard.entries[key] = cache;
+		}
+
+		bool FileCache::isWatched(const std::string& key)
+		{
+			FileCache marker;
+			return lookup(getDirectoryMarker(Utils::FileSystem::getParent(key)), marker) && marker.watched;
+		}
+
+		int FileCache::fromStat64(const std::string& key, struct stat64* info)
+		{
+			unsigned int generation = getGeneration();
+			int ret = stat64(key.c_str(), info);
+
+			FileCache cache(ret == 0, false);
+			if (cache.exists)
 			{
-				if (!mEnabled)
-					return nullptr;
+				cache.directory = S_ISDIR(info->st_mode);
+#ifndef WIN32
+				cache.isSymLink = S_ISLNK(info->st_mode);
+#endif
+			}
 
-				std::unique_lock<std::mutex> lock(mFileCacheMutex);
+			add(key, cache, generation);
 
-				auto it = mFileCache.find(key);
-				if (it != mFileCache.cend())
-					return &it->second;
+			return ret;
+		}
 
-				it = mFileCache.find(Utils::FileSystem::getParent(key)+"/*");
-				if (it != mFileCache.cend())
-				{
-					mFileCache[key] = FileCache(false, false);
-					return &mFileCache[key];
-				}				
+		void FileCache::add(const std::string& key, FileCache cache, unsigned int generation)
+		{
+			// Outside activator scopes, only keep existing entries of watched directories
+			if (!mEnabled && (!cache.exists || !isWatched(key)))
+				return;
+
+			store(key, cache, generation);
+		}
+
+		// Before listing a directory, so that changes made while it is read are seen
+		bool FileCache::watch(const std::string& path)
+		{
+			return mEnabled && watchDirectory(path);
+		}
+
+		// After listing a directory : the marker says that every entry of the directory is in the cache
+		void FileCache::addDirectory(const std::string& path, bool watched, unsigned int generation)
+		{
+			if (!mEnabled)
+				return;
+
+			FileCache marker(true, true);
+			marker.watched = watched;
+			store(getDirectoryMarker(path), marker, generation);
+		}
 
-				return nullptr;
+		bool FileCache::get(const std::string& key, FileCache& cache)
+		{
+			if (!mEnabled)
+			{
+				// Missing entries are not trusted outside activator scopes : a watch event may still be pending
+				return isWatched(key) && lookup(key, cache) && cache.exists;
 			}
 
-			static void resetCache()
+			unsigned int generation = getGeneration();
+
+			if (lookup(key, cache))
+				return true;
+
+			// The parent has been listed and the file was not in it
+			FileCache marker;
+			if (lookup(getDirectoryMarker(Utils::FileSystem::getParent(key)), marker))
 			{
-				std::unique_lock<std::mutex> lock(mFileCacheMutex);
-				mFileCache.clear();
+				cache = FileCache(false, false);
+				store(key, cache, generation);
+				return true;
 			}
 
-			static void setEnabled(bool value) { mEnabled = value; }
+			return false;
+		}
 
-		private:
-			static std::map<std::string, FileCache> mFileCache;
-			static std::mutex mFileCacheMutex;
-			static bool mEnabled;
-		};
+		void FileCache::invalidate(const std::string& key)
+		{
+			FileCacheShard& shard = getFileCacheShard(key);
+			std::unique_lock<std::mutex> lock(shard.lock);
+			shard.entries.erase(key);
+			mGeneration++;
+		}
 
-		std::map<std::string, FileCache> FileCache::mFileCache;
-		std::mutex FileCache::mFileCacheMutex;
-		bool FileCache::mEnabled = false;
+		// Called when we change something ourselves, without waiting for the watcher
+		void FileCache::onChanged(const std::string& path)
+		{
+			invalidate(path);
+			invalidate(getDirectoryMarker(Utils::FileSystem::getParent(path)));
+		}
+
+		void FileCache::resetCache()
+		{
+			mGeneration++;
+
+			for (int i = 0; i < FILECACHE_SHARDS; i++)
+			{
+				std::unique_lock<std::mutex> lock(sFileCacheShards[i].lock);
+				sFileCacheShards[i].entries.clear();
+			}
+		}
+
+		// Drops what can't be kept once the activator scope is over
+		void FileCache::purge()
+		{
+			for (int i = 0; i < FILECACHE_SHARDS; i++)
+			{
+				std::unique_lock<std::mutex> lock(sFileCacheShards[i].lock);
+				for (auto it = sFileCacheShards[i].entries.cbegin(); it != sFileCacheShards[i].entries.cend(); )
+				{
+					if (Utils::String::endsWith(it->first, "/*") ? !it->second.watched : !it->second.exists)
+						it = sFileCacheShards[i].entries.erase(it);
+					else
+						it++;
+				}
+			}
+
+			// Entries whose directory is not watched
+			for (int i = 0; i < FILECACHE_SHARDS; i++)
+			{
+				std::vector<std::string> keys;
+
+				{
+					std::unique_lock<std::mutex> lock(sFileCacheShards[i].lock);
+					for (auto& entry : sFileCacheShards[i].entries)
+						if (!Utils::String::endsWith(entry.first, "/*"))
+							keys.push_back(entry.first);
+				}
+
+				for (auto& key : keys)
+					if (!isWatched(key))
+						invalidate(key);
+			}
+		}
 
 		FileSystemCacheActivator::FileSystemCacheActivator()
 		{
 			if (mReferenceCount == 0)
-			{
 				FileCache::setEnabled(true);
-				FileCache::resetCache();
-			}
 
 			mReferenceCount++;
 		}
@@ -174,7 +444,7 @@ namespace Utils
 			if (mReferenceCount <= 0)
 			{
 				FileCache::setEnabled(false);
-				FileCache::resetCache();
+				FileCache::purge();
 			}
 		}
 
@@ -188,7 +458,8 @@ namespace Utils
 			// only parse the directory, if it's a directory
 			if (isDirectory(path))
 			{
-				FileCache::add(path + "/*", FileCache(true, true));
+				unsigned int generation = FileCache::getGeneration();
+				bool watched = FileCache::watch(path);
 
 #if defined(_WIN32)
 				WIN32_FIND_DATAW findData;
@@ -214,7 +485,7 @@ namespace Utils
 						fi.directory = (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == FILE_ATTRIBUTE_DIRECTORY;
 						contentList.push_back(fi);			
 
-						FileCache::add(fi.path, FileCache((DWORD)findData.dwFileAttributes));
+						FileCache::add(fi.path, FileCache((DWORD)findData.dwFileAttributes), generation);
 					} 
 					while (FindNextFileW(hFind, &findData));
 
@@ -243,7 +514,7 @@ namespace Utils
 							fi.directory = (entry->d_type == 4); // DT_DIR;
 							contentList.push_back(fi);
 
-							FileCache::add(fullName, FileCache(entry, fi.hidden));
+							FileCache::add(fullName, FileCache(entry, fi.hidden), generation);
 						}
 					}
 
@@ -251,6 +522,7 @@ namespace Utils
 				}
 #endif // _WIN32
 
+				FileCache::addDirectory(path, watched, generation);
 			}
 
 			// return the content list
@@ -266,7 +538,8 @@ namespace Utils
 			// only parse the directory, if it's a directory
 			if(isDirectory(path))
 			{		
-				FileCache::add(path + "/*", FileCache(true, true));
+				unsigned int generation = FileCache::getGeneration();
+				bool watched = FileCache::watch(path);
 
 #if defined(_WIN32)
 				WIN32_FIND_DATAW findData;
@@ -294,7 +567,7 @@ namespace Utils
 							
 						contentList.push_back(fullName);
 
-						FileCache::add(fullName, FileCache((DWORD)findData.dwFileAttributes));
+						FileCache::add(fullName, FileCache((DWORD)findData.dwFileAttributes), generation);
 
 						if (_recursive && (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == FILE_ATTRIBUTE_DIRECTORY)
 						{
@@ -323,7 +596,7 @@ namespace Utils
 						{
 							std::string fullName(getGenericPath(path + "/" + name));
 
-							FileCache::add(fullName, FileCache(fullName, entry));
+							FileCache::add(fullName, FileCache(fullName, entry), generation);
 
 							if (!includeHidden && Utils::FileSystem::isHidden(fullName))
 								continue;
@@ -339,6 +612,7 @@ namespace Utils
 				}
 #endif // _WIN32
 
+				FileCache::addDirectory(path, watched, generation);
 			}
 
 			// return the content list
@@ -769,7 +1043,9 @@ namespace Utils
 				return true;
 
 			// try to remove file
-			return (unlink(path.c_str()) == 0);
+			bool removed = (unlink(path.c_str()) == 0);
+			FileCache::onChanged(path);
+			return removed;
 
 		} // removeFile
 
@@ -802,14 +1078,14 @@ namespace Utils
 			fclose(dest);
 			fclose(source);
 
+			FileCache::onChanged(pathD);
 			return true;
 		} // removeFile
 
 		bool createDirectory(const std::string& _path)
 		{
-			FileCache::resetCache();
-
 			std::string path = getGenericPath(_path);
+			FileCache::invalidate(path);
 
 			// don't create if it already exists
 			if(exists(path))
@@ -817,7 +1093,10 @@ namespace Utils
 
 			// try to create directory
 			if(mkdir(path.c_str(), 0755) == 0)
+			{
+				FileCache::onChanged(path);
 				return true;
+			}
 
 			// failed to create directory, try to create the parent
 			std::string parent = getParent(path);
@@ -827,7 +1106,9 @@ namespace Utils
 				createDirectory(parent);
 
 			// try to create directory again now that the parent should exist
-			return (mkdir(path.c_str(), 0755) == 0);
+			bool created = (mkdir(path.c_str(), 0755) == 0);
+			FileCache::onChanged(path);
+			return created;
 
 		} // createDirectory
 
@@ -836,13 +1117,14 @@ namespace Utils
 			if (_path.empty())
 				return false;
 
-			auto it = FileCache::get(_path);
-			if (it != nullptr)
-				return it->exists;
+			FileCache cache;
+			if (FileCache::get(_path, cache))
+				return cache.exists;
 
 #ifdef WIN32			
+			unsigned int generation = FileCache::getGeneration();
 			DWORD dwAttr = GetFileAttributes(_path.c_str());
-			FileCache::add(_path, FileCache(dwAttr));
+			FileCache::add(_path, FileCache(dwAttr), generation);
 			if (0xFFFFFFFF == dwAttr)
 				return false;
 
@@ -871,6 +1153,18 @@ namespace Utils
 			return 0;
 		}
 
+		time_t getFileModificationDate(const std::string& _path)
+		{
+			std::string path = getGenericPath(_path);
+			struct stat64 info;
+
+			// check if stat64 succeeded
+			if ((stat64(path.c_str(), &info) == 0))
+				return info.st_mtime;
+
+			return 0;
+		}
+
 		bool isAbsolute(const std::string& _path)
 		{
 			if (_path.size() >= 2 && _path[0] == ':' && _path[1] == '/')
@@ -888,9 +1182,9 @@ namespace Utils
 
 		bool isRegularFile(const std::string& _path)
 		{
-			auto it = FileCache::get(_path);
-			if (it != nullptr)
-				return it->exists && !it->directory && !it->isSymLink;
+			FileCache cache;
+			if (FileCache::get(_path, cache))
+				return cache.exists && !cache.directory && !cache.isSymLink;
 
 			std::string path = getGenericPath(_path);
 			struct stat64 info;
@@ -906,13 +1200,14 @@ namespace Utils
 
 		bool isDirectory(const std::string& _path)
 		{
-			auto it = FileCache::get(_path);
-			if (it != nullptr)
-				return it->exists && it->directory;
+			FileCache cache;
+			if (FileCache::get(_path, cache))
+				return cache.exists && cache.directory;
 
 #ifdef WIN32
+			unsigned int generation = FileCache::getGeneration();
 			DWORD dwAttr = GetFileAttributes(_path.c_str());
-			FileCache::add(_path, FileCache(dwAttr));
+			FileCache::add(_path, FileCache(dwAttr), generation);
 			return (dwAttr != INVALID_FILE_ATTRIBUTES) && (dwAttr & FILE_ATTRIBUTE_DIRECTORY);		
 #else
 			std::string path = getGenericPath(_path);
@@ -929,16 +1224,17 @@ namespace Utils
 
 		bool isSymlink(const std::string& _path)
 		{		
-			auto it = FileCache::get(_path);
-			if (it != nullptr)
-				return it->exists && it->isSymLink;
+			FileCache cache;
+			if (FileCache::get(_path, cache))
+				return cache.exists && cache.isSymLink;
 				
 			std::string path = getGenericPath(_path);
 
 #ifdef WIN32
 			// check for symlink attribute
+			unsigned int generation = FileCache::getGeneration();
 			DWORD Attributes = GetFileAttributes(path.c_str());
-			FileCache::add(_path, FileCache(Attributes));
+			FileCache::add(_path, FileCache(Attributes), generation);
 			return (Attributes != INVALID_FILE_ATTRIBUTES) && (Attributes & FILE_ATTRIBUTE_REPARSE_POINT);
 #else // WIN32
 			struct stat64 info;
@@ -955,16 +1251,17 @@ namespace Utils
 
 		bool isHidden(const std::string& _path)
 		{
-			auto it = FileCache::get(_path);
-			if (it != nullptr)
-				return it->exists && it->hidden;
+			FileCache cache;
+			if (FileCache::get(_path, cache))
+				return cache.exists && cache.hidden;
 
 			std::string path = getGenericPath(_path);
 
 #ifdef WIN32
 			// check for hidden attribute
+			unsigned int generation = FileCache::getGeneration();
 			DWORD Attributes = GetFileAttributes(path.c_str());
-			FileCache::add(_path, FileCache(Attributes));
+			FileCache::add(_path, FileCache(Attributes), generation);
 			return (Attributes != INVALID_FILE_ATTRIBUTES && Attributes & FILE_ATTRIBUTE_HIDDEN);				
 #endif // _WIN32
 
@@ -1045,6 +1342,8 @@ namespace Utils
 			fs.open(fileName.c_str(), std::fstream::out);
 			fs << text;
 			fs.close();
+
+			FileCache::onChanged(getGenericPath(fileName));
 		}
 	} // FileSystem::
 
@@ -4,6 +4,7 @@
 
 #include <list>
 #include <string>
+#include <time.h>
 
 namespace Utils
 {
@@ -36,6 +37,7 @@ namespace Utils
 		bool        createDirectory    (const std::string& _path);
 		bool        exists             (const std::string& _path);
 		size_t		getFileSize(const std::string& _path);
+		time_t		getFileModificationDate(const std::string& _path);
 		bool        isAbsolute         (const std::string& _path);
 		bool        isRegularFile      (const std::string& _path);
 		bool        isDirectory        (const std::string& _path);
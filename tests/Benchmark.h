@@ -0,0 +1,39 @@
+#pragma once
+#ifndef ES_TESTS_BENCHMARK_H
+#define ES_TESTS_BENCHMARK_H
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+// Runs func iterations times and prints the total and per-iteration durations. Returns the total in milliseconds
+template<typename T>
+double benchmark(const std::string& name, size_t iterations, T func)
+{
+	auto start = std::chrono::steady_clock::now();
+
+	for (size_t i = 0; i < iterations; i++)
+		func(i);
+
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+	std::cout << std::left << std::setw(48) << name << std::right << std::fixed << std::setprecision(2)
+		<< std::setw(10) << elapsed.count() << " ms" << std::setw(12) << (elapsed.count() * 1000000.0 / (double)iterations) << " ns/op\n";
+
+	return elapsed.count();
+}
+
+// Keeps the optimizer from removing a computation whose result is unused
+template<typename T>
+void doNotOptimize(const T& value)
+{
+#if defined(__GNUC__)
+	asm volatile("" : : "r,m"(value) : "memory");
+#else
+	static volatile char sink;
+	sink = *(const volatile char*)&value;
+#endif
+}
+
+#endif // ES_TESTS_BENCHMARK_H
@@ -0,0 +1,110 @@
+#include "utils/FileSystemUtil.h"
+#include "EsLocale.h"
+#include "Settings.h"
+#include "Test.h"
+#include <fstream>
+#include <memory>
+#include <string.h>
+#include <vector>
+
+// The translations cached by the call sites of _() must be the ones getText finds, for every message of every
+// shipped language, and must follow the language when it changes.
+
+static const char* sLanguages[] = { "br", "es", "fr", "ko" };
+
+static std::vector<std::string> readMessageIds(const std::string& language)
+{
+	std::vector<std::string> ids;
+
+	std::ifstream file(std::string(ES_SOURCE_DIR) + "/resources/locale/" + language + "/emulationstation2.po");
+	std::string line;
+
+	while (std::getline(file, line))
+	{
+		if (line.find("msgid ") != 0)
+			continue;
+
+		// same parsing as EsLocale
+		auto start = line.find("\"");
+		auto end = start != std::string::npos ? line.find("\"", start + 1) : std::string::npos;
+		if (end != std::string::npos && end > start + 1)
+			ids.push_back(line.substr(start + 1, end - start - 1));
+	}
+
+	return ids;
+}
+
+static void setLanguage(const std::string& language)
+{
+	Settings::getInstance()->setString("Language", language);
+}
+
+int main(int /*argc*/, char** /*argv*/)
+{
+	// the bundled translations, not the ones of the user running the test
+	Utils::FileSystem::setHomePath(Utils::FileSystem::getCWDPath() + "/EsLocaleTest");
+	Utils::FileSystem::setExePath(ES_SOURCE_DIR);
+
+	std::vector<std::string> ids;
+	for (auto language : sLanguages)
+	{
+		std::vector<std::string> languageIds = readMessageIds(language);
+		TEST_CHECK(!languageIds.empty());
+		ids.insert(ids.end(), languageIds.begin(), languageIds.end());
+	}
+
+	// one cache per message, kept across the languages like the cache of a call site
+	std::vector<std::unique_ptr<EsLocale::LiteralCache>> caches;
+	for (size_t i = 0; i < ids.size(); i++)
+		caches.push_back(std::unique_ptr<EsLocale::LiteralCache>(new EsLocale::LiteralCache()));
+
+	for (int pass = 0; pass < 2; pass++)
+	{
+		for (auto language : sLanguages)
+		{
+			setLanguage(language);
+
+			int translated = 0;
+
+			for (size_t i = 0; i < ids.size(); i++)
+			{
+				std::string expected = EsLocale::getText(ids[i]);
+				if (expected != ids[i])
+					translated++;
+
+				// first call fills the cache, the second one reads it
+				TEST_CHECK(EsLocale::getTextFromLiteral(ids[i].c_str(), caches[i].get()) == expected);
+				TEST_CHECK(EsLocale::getTextFromLiteral(ids[i].c_str(), caches[i].get()) == expected);
+			}
+
+			TEST_CHECK(EsLocale::getLanguage() == language);
+			TEST_CHECK(translated > 0);
+		}
+	}
+
+	// a literal, through the macro
+	setLanguage("fr");
+	TEST_CHECK(_("EMULATOR SETTINGS") == EsLocale::getText(std::string("EMULATOR SETTINGS")));
+	TEST_CHECK(_("EMULATOR SETTINGS") != "EMULATOR SETTINGS");
+
+	setLanguage("en");
+	TEST_CHECK(_("EMULATOR SETTINGS") == "EMULATOR SETTINGS");
+
+	// a buffer reused with different texts at the same call site
+	setLanguage("fr");
+	for (auto& id : ids)
+	{
+		char buffer[256];
+		strncpy(buffer, id.c_str(), sizeof(buffer) - 1);
+		buffer[sizeof(buffer) - 1] = 0;
+
+		TEST_CHECK(_(buffer) == EsLocale::getText(std::string(buffer)));
+	}
+
+	// the same cache given different texts
+	EsLocale::LiteralCache shared;
+	for (auto& id : ids)
+		TEST_CHECK(EsLocale::getTextFromLiteral(id.c_str(), &shared) == EsLocale::getText(id));
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,150 @@
+#include "utils/FileSystemUtil.h"
+#include "Test.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <stdio.h>
+#include <thread>
+#include <vector>
+
+// Readers hammer the file system cache while files are created and removed, through Utils::FileSystem and behind its back.
+// Once one of our changes has returned, or once the watcher had the time to see a change made by someone else,
+// no reader may get a stale answer.
+
+#define FILE_COUNT 32
+#define READERS    4
+#define ROUNDS     500
+#define WATCH_WAIT 2000 // ms given to the watcher to see an outside change
+
+static std::string sRoot;
+static std::atomic<bool> sRunning(true);
+
+static std::string fileName(int index)
+{
+	return sRoot + "/file" + std::to_string(index) + ".txt";
+}
+
+static bool existsOnDisk(const std::string& path)
+{
+	FILE* file = fopen(path.c_str(), "rb");
+	if (file == nullptr)
+		return false;
+
+	fclose(file);
+	return true;
+}
+
+static bool isListed(const std::string& path)
+{
+	auto content = Utils::FileSystem::getDirContent(sRoot);
+	return std::find(content.cbegin(), content.cend(), path) != content.cend();
+}
+
+static void readerProc()
+{
+	while (sRunning)
+	{
+		for (int i = 0; i < FILE_COUNT; i++)
+		{
+			Utils::FileSystem::exists(fileName(i));
+			Utils::FileSystem::isRegularFile(fileName(i));
+		}
+
+		Utils::FileSystem::getDirContent(sRoot);
+	}
+}
+
+// Outside activator scopes only the watcher corrects the cache : give it some time
+static bool waitFor(const std::string& path, bool expected)
+{
+	auto start = std::chrono::steady_clock::now();
+
+	while (Utils::FileSystem::exists(path) != expected)
+	{
+		if (std::chrono::steady_clock::now() - start > std::chrono::milliseconds(WATCH_WAIT))
+			return false;
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	}
+
+	return true;
+}
+
+int main(int /*argc*/, char** /*argv*/)
+{
+	sRoot = Utils::FileSystem::getGenericPath(Utils::FileSystem::getCWDPath() + "/FileSystemCacheTest");
+	Utils::FileSystem::createDirectory(sRoot);
+
+	for (int i = 0; i < FILE_COUNT; i++)
+		Utils::FileSystem::removeFile(fileName(i));
+
+	std::vector<std::thread> readers;
+	for (int i = 0; i < READERS; i++)
+		readers.push_back(std::thread(readerProc));
+
+	std::mt19937 random(0x45533432);
+
+	// Our own changes, inside an activator scope : they must be seen as soon as they return
+	{
+		Utils::FileSystem::FileSystemCacheActivator fsc;
+
+		for (int round = 0; round < ROUNDS; round++)
+		{
+			std::string path = fileName(random() % FILE_COUNT);
+
+			if (existsOnDisk(path))
+			{
+				TEST_CHECK(Utils::FileSystem::removeFile(path));
+				TEST_CHECK(!Utils::FileSystem::exists(path));
+				TEST_CHECK(!Utils::FileSystem::isRegularFile(path));
+				TEST_CHECK(!isListed(path));
+			}
+			else
+			{
+				Utils::FileSystem::writeAllText(path, "round " + std::to_string(round));
+				TEST_CHECK(Utils::FileSystem::exists(path));
+				TEST_CHECK(Utils::FileSystem::isRegularFile(path));
+				TEST_CHECK(isListed(path));
+			}
+		}
+	}
+
+	// Changes made behind our back, outside activator scopes : the directory was listed above, so it is watched where supported
+	for (int round = 0; round < ROUNDS / 10; round++)
+	{
+		std::string path = fileName(random() % FILE_COUNT);
+
+		if (existsOnDisk(path))
+		{
+			TEST_CHECK(remove(path.c_str()) == 0);
+			TEST_CHECK(waitFor(path, false));
+		}
+		else
+		{
+			FILE* file = fopen(path.c_str(), "wb");
+			TEST_CHECK(file != nullptr);
+			if (file != nullptr)
+				fclose(file);
+
+			TEST_CHECK(waitFor(path, true));
+		}
+	}
+
+	sRunning = false;
+	for (auto& reader : readers)
+		reader.join();
+
+	// Nothing stale was left behind by the readers
+	for (int i = 0; i < FILE_COUNT; i++)
+	{
+		std::string path = fileName(i);
+		TEST_CHECK(Utils::FileSystem::exists(path) == existsOnDisk(path));
+		TEST_CHECK(Utils::FileSystem::isRegularFile(path) == existsOnDisk(path));
+	}
+
+	for (int i = 0; i < FILE_COUNT; i++)
+		Utils::FileSystem::removeFile(fileName(i));
+
+	return TEST_RESULT();
+}
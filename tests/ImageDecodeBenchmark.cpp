@@ -0,0 +1,62 @@
+#include "ImageIO.h"
+#include "Benchmark.h"
+#include <FreeImage.h>
+#include <fstream>
+#include <iterator>
+#include <stdlib.h>
+
+// Decoding of scraped media : full size, then at the size of a gamelist image, which lets libjpeg scale
+// in the DCT domain. Usage : ImageDecodeBenchmark <image> [maxWidth maxHeight]
+
+#define ITERATIONS 20
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		std::cerr << "usage : " << argv[0] << " <image> [maxWidth maxHeight]\n";
+		return 1;
+	}
+
+	std::ifstream file(argv[1], std::ios::binary);
+	std::vector<unsigned char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	if (data.empty())
+	{
+		std::cerr << "unable to read " << argv[1] << "\n";
+		return 1;
+	}
+
+	int maxWidth = argc > 3 ? atoi(argv[2]) : 640;
+	int maxHeight = argc > 3 ? atoi(argv[3]) : 480;
+
+#ifdef FREEIMAGE_LIB
+	FreeImage_Initialise();
+#endif
+
+	size_t width = 0;
+	size_t height = 0;
+	Vector2i baseSize;
+	Vector2i packedSize;
+
+	benchmark("full size decode", ITERATIONS, [&](size_t)
+	{
+		unsigned char* pixels = ImageIO::loadFromMemoryRGBA32Ex(data.data(), data.size(), width, height, 0, 0, false, baseSize, packedSize);
+		delete[] pixels;
+	});
+
+	std::cout << "  " << width << "x" << height << "\n";
+
+	benchmark("decode to " + std::to_string(maxWidth) + "x" + std::to_string(maxHeight), ITERATIONS, [&](size_t)
+	{
+		unsigned char* pixels = ImageIO::loadFromMemoryRGBA32Ex(data.data(), data.size(), width, height, maxWidth, maxHeight, false, baseSize, packedSize);
+		delete[] pixels;
+	});
+
+	std::cout << "  " << width << "x" << height << " (image is " << baseSize.x() << "x" << baseSize.y() << ")\n";
+
+#ifdef FREEIMAGE_LIB
+	FreeImage_DeInitialise();
+#endif
+
+	return 0;
+}
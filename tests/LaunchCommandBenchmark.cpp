@@ -0,0 +1,75 @@
+#include "utils/FileSystemUtil.h"
+#include "utils/StringUtil.h"
+#include "Benchmark.h"
+#include "Scripting.h"
+#include "SystemData.h"
+#include "platform.h"
+#include <fstream>
+
+#if !WIN32
+#include <sys/stat.h>
+#endif
+
+// Expansion of a launch command against the replace chain it replaced, then a launch and return with a stub
+// emulator which exits at once : the part of FileData::launchGame done without a window, the game-start and
+// game-end events included. Window::deinit / init and the texture uploads of the resume need a display.
+
+#define EXPANSIONS 1000000
+#define LAUNCHES   50
+
+static std::string expandPrevious(std::string command, const std::string (&values)[LaunchCommandTemplate::VARIABLE_COUNT])
+{
+	command = Utils::String::replace(command, "%EMULATOR%", values[LaunchCommandTemplate::EMULATOR]);
+	command = Utils::String::replace(command, "%CORE%", values[LaunchCommandTemplate::CORE]);
+
+	command = Utils::String::replace(command, "%ROM%", values[LaunchCommandTemplate::ROM]);
+	command = Utils::String::replace(command, "%BASENAME%", values[LaunchCommandTemplate::BASENAME]);
+	command = Utils::String::replace(command, "%ROM_RAW%", values[LaunchCommandTemplate::ROM_RAW]);
+	command = Utils::String::replace(command, "%SYSTEM%", values[LaunchCommandTemplate::SYSTEM]);
+	command = Utils::String::replace(command, "%HOME%", values[LaunchCommandTemplate::HOME]);
+
+	return command;
+}
+
+int main(int /*argc*/, char** /*argv*/)
+{
+	std::string home = Utils::FileSystem::getCWDPath() + "/LaunchCommandBenchmark";
+	Utils::FileSystem::createDirectory(home + "/.emulationstation");
+	Utils::FileSystem::setHomePath(home);
+	Utils::FileSystem::setExePath(home + "/exe");
+
+	const std::string values[LaunchCommandTemplate::VARIABLE_COUNT] =
+	{
+		"retroarch", "snes9x", "/home/pi/RetroPie/roms/snes/Super\\ Mario\\ World.sfc", "Super Mario World",
+		"/home/pi/RetroPie/roms/snes/Super Mario World.sfc", "snes", home
+	};
+
+	const std::string command = "%HOME%/stub-emulator.sh %EMULATOR% -L %CORE% --config %HOME%/.config/%SYSTEM%.cfg %ROM% \"%BASENAME%\"";
+	LaunchCommandTemplate launchCommand(command);
+
+	benchmark("LaunchCommandTemplate::expand", EXPANSIONS, [&](size_t) { doNotOptimize(launchCommand.expand(values)); });
+	benchmark("replace chain (previous)", EXPANSIONS, [&](size_t) { doNotOptimize(expandPrevious(command, values)); });
+
+#if WIN32
+	std::cout << "stub emulator, skipped on Windows\n";
+#else
+	std::string stub = home + "/stub-emulator.sh";
+	{
+		std::ofstream script(stub);
+		script << "#!/bin/sh\nexit 0\n";
+	}
+
+	chmod(stub.c_str(), 0755);
+
+	benchmark("launch and return, stub emulator", LAUNCHES, [&](size_t)
+	{
+		std::string expanded = launchCommand.expand(values);
+
+		Scripting::fireEvent("game-start", values[LaunchCommandTemplate::ROM], values[LaunchCommandTemplate::BASENAME]);
+		runSystemCommand(expanded, values[LaunchCommandTemplate::BASENAME], nullptr);
+		Scripting::fireEvent("game-end");
+	});
+#endif
+
+	return 0;
+}
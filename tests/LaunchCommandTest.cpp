@@ -0,0 +1,114 @@
+#include "utils/StringUtil.h"
+#include "SystemData.h"
+#include "Test.h"
+#include <ctype.h>
+#include <random>
+
+// LaunchCommandTemplate must expand commands like the Utils::String::replace chain it replaced, adjacent, unknown
+// and partial variables included. By design it differs when a value contains a variable, which the chain expanded
+// again, and when two variables share a '%', which the chain resolved in its replace order.
+
+static const std::string sValues[LaunchCommandTemplate::VARIABLE_COUNT] =
+{
+	"retroarch", "snes9x", "/home/pi/RetroPie/roms/snes/Super\\ Mario\\ World.sfc", "Super Mario World",
+	"/home/pi/RetroPie/roms/snes/Super Mario World.sfc", "snes", "/home/pi"
+};
+
+static std::string expandPrevious(std::string command, const std::string (&values)[LaunchCommandTemplate::VARIABLE_COUNT])
+{
+	command = Utils::String::replace(command, "%EMULATOR%", values[LaunchCommandTemplate::EMULATOR]);
+	command = Utils::String::replace(command, "%CORE%", values[LaunchCommandTemplate::CORE]);
+
+	command = Utils::String::replace(command, "%ROM%", values[LaunchCommandTemplate::ROM]);
+	command = Utils::String::replace(command, "%BASENAME%", values[LaunchCommandTemplate::BASENAME]);
+	command = Utils::String::replace(command, "%ROM_RAW%", values[LaunchCommandTemplate::ROM_RAW]);
+	command = Utils::String::replace(command, "%SYSTEM%", values[LaunchCommandTemplate::SYSTEM]);
+	command = Utils::String::replace(command, "%HOME%", values[LaunchCommandTemplate::HOME]);
+
+	return command;
+}
+
+static std::string expand(const std::string& command, const std::string (&values)[LaunchCommandTemplate::VARIABLE_COUNT] = sValues)
+{
+	return LaunchCommandTemplate(command).expand(values);
+}
+
+int main(int /*argc*/, char** /*argv*/)
+{
+	const char* sameAsPrevious[] =
+	{
+		"",
+		"%ROM%",
+		"nothing to expand",
+		"%HOME%/RetroPie/supplementary/runcommand/runcommand.sh 0 _SYS_ %SYSTEM% %ROM%",
+		"%EMULATOR% -L %CORE% --config %HOME%/.config/retroarch.cfg %ROM%",
+		"%ROM%%CORE%%SYSTEM%",                           // adjacent
+		"%BASENAME%.cfg \"%ROM_RAW%\"",
+		"%ROM_RAW%%ROM%",                                // a variable prefix of another
+		"%UNKNOWN% %ROM% %PATH%",                        // unknown, kept as is
+		"%ROM %CORE% ROM% %ROM",                         // partial
+		"%%ROM%% 100% %",                                // lone percents
+		"%rom% %Rom%",                                   // case sensitive
+		"%SYSTEM%"
+	};
+
+	for (auto command : sameAsPrevious)
+		TEST_CHECK(expand(command) == expandPrevious(command, sValues));
+
+	TEST_CHECK(expand("%EMULATOR% -L %CORE% %ROM%") == "retroarch -L snes9x /home/pi/RetroPie/roms/snes/Super\\ Mario\\ World.sfc");
+	TEST_CHECK(expand("%UNKNOWN%%ROM") == "%UNKNOWN%%ROM");
+	TEST_CHECK(expand("%%CORE%%") == "%snes9x%");
+
+	// Random commands made of variables, text and separators
+	const char* tokens[] = { "%EMULATOR%", "%CORE%", "%ROM%", "%BASENAME%", "%ROM_RAW%", "%SYSTEM%", "%HOME%", "%UNKNOWN%", "-L", " ", "\"", "/", "x", "ROM", "%" };
+	const int tokenCount = sizeof(tokens) / sizeof(tokens[0]);
+
+	std::mt19937 random(0x45533439);
+
+	for (int i = 0; i < 100000; i++)
+	{
+		std::string command;
+		int length = random() % 12;
+		std::string previous;
+
+		for (int t = 0; t < length; t++)
+		{
+			std::string token = tokens[random() % tokenCount];
+
+			// a name right after a '%' can make two variables share it, see below
+			if (!previous.empty() && previous.back() == '%' && isalpha(token[0]))
+				continue;
+
+			command += token;
+			previous = token;
+		}
+
+		std::string expanded = expand(command);
+		std::string expected = expandPrevious(command, sValues);
+
+		TEST_CHECK(expanded == expected);
+		if (expanded != expected)
+		{
+			std::cerr << "  command : " << command << "\n  expanded : " << expanded << "\n  previous : " << expected << "\n";
+			break;
+		}
+	}
+
+	// Values are inserted as is, the chain expanded the variables they contained
+	std::string values[LaunchCommandTemplate::VARIABLE_COUNT];
+	for (int i = 0; i < LaunchCommandTemplate::VARIABLE_COUNT; i++)
+		values[i] = sValues[i];
+
+	values[LaunchCommandTemplate::ROM] = "/roms/100%SYSTEM%.zip";
+	TEST_CHECK(expand("%EMULATOR% %ROM%", values) == "retroarch /roms/100%SYSTEM%.zip");
+
+	// Variables sharing a '%' : read from left to right, the chain replaced %CORE% first
+	TEST_CHECK(expand("%ROM%CORE%") == sValues[LaunchCommandTemplate::ROM] + "CORE%");
+
+	// Empty template, empty values
+	std::string empty[LaunchCommandTemplate::VARIABLE_COUNT];
+	TEST_CHECK(LaunchCommandTemplate().expand(sValues).empty());
+	TEST_CHECK(expand("%EMULATOR% %ROM%", empty) == " ");
+
+	return TEST_RESULT();
+}
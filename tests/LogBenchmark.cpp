@@ -0,0 +1,152 @@
+#include "utils/FileSystemUtil.h"
+#include "Benchmark.h"
+#include "Log.h"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <stdio.h>
+#include <thread>
+#include <vector>
+
+// LOG() from 8 threads at once, as when the systems are loaded in parallel, and the time of a frame that logs
+// a few lines while the other threads flood the log. "previous" is the former LOG() : a global lock around
+// the write to the file, on the calling thread.
+
+#define THREADS          8
+#define MESSAGES         100000 // per thread
+#define FRAMES           600
+#define FRAME_MESSAGES   5
+#define FRAME_WORK       200000 // iterations of busy work, roughly a cheap frame
+
+static std::mutex sPreviousLock;
+static FILE* sPreviousFile = NULL;
+
+static void logPrevious(int thread, int index)
+{
+	std::ostringstream os;
+	os << "INFO\t" << "thread " << thread << " message " << index << " of the benchmark" << std::endl;
+
+	std::unique_lock<std::mutex> lock(sPreviousLock);
+	fprintf(sPreviousFile, "%s", os.str().c_str());
+}
+
+static void logQueued(int thread, int index)
+{
+	LOG(LogInfo) << "thread " << thread << " message " << index << " of the benchmark";
+}
+
+// Runs func(thread) on count threads, returns the time until they all ended in milliseconds
+template<typename T>
+static double runThreads(int count, T func)
+{
+	auto start = std::chrono::steady_clock::now();
+
+	std::vector<std::thread> threads;
+	for (int i = 0; i < count; i++)
+		threads.push_back(std::thread(func, i));
+
+	for (auto& thread : threads)
+		thread.join();
+
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	return elapsed.count();
+}
+
+static void printThroughput(const std::string& name, double ms, size_t messages)
+{
+	std::cout << std::left << std::setw(48) << name << std::right << std::fixed << std::setprecision(2)
+		<< std::setw(10) << ms << " ms" << std::setw(12) << (ms * 1000000.0 / (double)messages) << " ns/msg\n";
+}
+
+// Frames of the "render" thread, logging a few lines each, while the other threads log as fast as they can
+template<typename T>
+static void measureFrames(const std::string& name, int flooders, T logFunc)
+{
+	std::atomic<bool> running(true);
+	std::vector<double> frames;
+	volatile unsigned int work = 0;
+
+	std::vector<std::thread> threads;
+	for (int i = 0; i < flooders; i++)
+		threads.push_back(std::thread([&, i]() { for (int index = 0; running; index++) logFunc(i + 1, index); }));
+
+	for (int frame = 0; frame < FRAMES; frame++)
+	{
+		auto start = std::chrono::steady_clock::now();
+
+		for (int i = 0; i < FRAME_WORK; i++)
+			work = work + i;
+
+		for (int i = 0; i < FRAME_MESSAGES; i++)
+			logFunc(0, frame * FRAME_MESSAGES + i);
+
+		std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+		frames.push_back(elapsed.count());
+	}
+
+	running = false;
+	for (auto& thread : threads)
+		thread.join();
+
+	std::sort(frames.begin(), frames.end());
+
+	double total = 0;
+	for (auto frame : frames)
+		total += frame;
+
+	std::cout << std::left << std::setw(48) << name << std::right << std::fixed << std::setprecision(3)
+		<< " avg " << std::setw(8) << (total / frames.size()) << " ms"
+		<< "  p99 " << std::setw(8) << frames[frames.size() * 99 / 100] << " ms"
+		<< "  max " << std::setw(8) << frames.back() << " ms\n";
+}
+
+int main(int /*argc*/, char** /*argv*/)
+{
+	std::string home = Utils::FileSystem::getCWDPath() + "/LogBenchmark";
+	Utils::FileSystem::createDirectory(home + "/.emulationstation");
+	Utils::FileSystem::setHomePath(home);
+
+	sPreviousFile = fopen((home + "/.emulationstation/es_log_previous.txt").c_str(), "w");
+	if (sPreviousFile == NULL)
+	{
+		std::cerr << "unable to create the log files in " << home << "\n";
+		return 1;
+	}
+
+	Log::setReportingLevel(LogInfo);
+	Log::init();
+
+	if (!Log::Enabled())
+	{
+		std::cerr << "unable to open " << Log::getLogPath() << "\n";
+		return 1;
+	}
+
+	for (int threads : { 1, THREADS })
+	{
+		size_t messages = (size_t)threads * MESSAGES;
+		std::string suffix = " (" + std::to_string(threads) + (threads > 1 ? " threads)" : " thread)");
+
+		printThroughput("LOG() previous" + suffix, runThreads(threads, [](int thread) { for (int i = 0; i < MESSAGES; i++) logPrevious(thread, i); }), messages);
+
+		double queued = runThreads(threads, [](int thread) { for (int i = 0; i < MESSAGES; i++) logQueued(thread, i); });
+		printThroughput("LOG() queued" + suffix, queued, messages);
+
+		// what the writer still has to do, off the logging threads
+		auto start = std::chrono::steady_clock::now();
+		Log::flush();
+		std::chrono::duration<double, std::milli> flushed = std::chrono::steady_clock::now() - start;
+		printThroughput("LOG() queued, until written" + suffix, queued + flushed.count(), messages);
+	}
+
+	std::cout << "\n";
+
+	measureFrames("frame, log idle", 0, logQueued);
+	measureFrames("frame, 7 threads logging, previous", THREADS - 1, logPrevious);
+	measureFrames("frame, 7 threads logging, queued", THREADS - 1, logQueued);
+
+	Log::close();
+	fclose(sPreviousFile);
+
+	return 0;
+}
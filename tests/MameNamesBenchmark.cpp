@@ -0,0 +1,57 @@
+#include "utils/FileSystemUtil.h"
+#include "Benchmark.h"
+#include "MameNames.h"
+#include <pugixml/src/pugixml.hpp>
+#include <vector>
+
+// Startup cost of the MAME names : the first boot parses the XML files and writes the database, the next ones
+// map it. Then the lookups done for each game of an arcade system, with names taken from the XML.
+
+#define STARTUPS 5
+#define LOOKUPS  1000000
+
+int main(int /*argc*/, char** /*argv*/)
+{
+	std::string home = Utils::FileSystem::getCWDPath() + "/MameNamesBenchmark";
+	Utils::FileSystem::createDirectory(home + "/.emulationstation");
+	Utils::FileSystem::setHomePath(home);
+	Utils::FileSystem::setExePath(ES_SOURCE_DIR);
+
+	std::string database = home + "/.emulationstation/mamenames.db";
+
+	benchmark("init, XML parsed and database written", STARTUPS, [&](size_t)
+	{
+		Utils::FileSystem::removeFile(database);
+		MameNames::init();
+		MameNames::deinit();
+	});
+
+	benchmark("init, database mapped", STARTUPS, [&](size_t)
+	{
+		MameNames::init();
+		MameNames::deinit();
+	});
+
+	std::vector<std::string> names;
+
+	pugi::xml_document doc;
+	if (doc.load_file(ES_SOURCE_DIR "/resources/mamenames.xml"))
+		for (pugi::xml_node gameNode = doc.child("game"); gameNode; gameNode = gameNode.next_sibling("game"))
+			names.push_back(gameNode.child("mamename").text().get());
+
+	if (names.empty())
+	{
+		std::cerr << "unable to read the MAME names\n";
+		return 1;
+	}
+
+	MameNames::init();
+	MameNames* mameNames = MameNames::getInstance();
+
+	benchmark("getRealName", LOOKUPS, [&](size_t i) { doNotOptimize(mameNames->getRealName(names[i % names.size()])); });
+	benchmark("isBios + isDevice", LOOKUPS, [&](size_t i) { doNotOptimize(mameNames->isBios(names[i % names.size()]) || mameNames->isDevice(names[i % names.size()])); });
+
+	MameNames::deinit();
+
+	return 0;
+}
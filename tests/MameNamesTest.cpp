@@ -0,0 +1,115 @@
+#include "utils/FileSystemUtil.h"
+#include "MameNames.h"
+#include "Test.h"
+#include <pugixml/src/pugixml.hpp>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <set>
+
+// Every entry of the shipped XML files must be found in the binary database, built from the XML or mapped
+// from the file written by a previous run, with the same answer as the XML parse.
+
+struct Expected
+{
+	std::map<std::string, std::string> names;
+	std::set<std::string> bioses;
+	std::set<std::string> devices;
+};
+
+static Expected parseXml()
+{
+	Expected expected;
+	pugi::xml_document doc;
+
+	if (doc.load_file(ES_SOURCE_DIR "/resources/mamenames.xml"))
+		for (pugi::xml_node gameNode = doc.child("game"); gameNode; gameNode = gameNode.next_sibling("game"))
+			expected.names.insert(std::make_pair(gameNode.child("mamename").text().get(), gameNode.child("realname").text().get())); // the first of duplicated names wins
+
+	if (doc.load_file(ES_SOURCE_DIR "/resources/mamebioses.xml"))
+		for (pugi::xml_node node = doc.child("bios"); node; node = node.next_sibling("bios"))
+			expected.bioses.insert(node.text().get());
+
+	if (doc.load_file(ES_SOURCE_DIR "/resources/mamedevices.xml"))
+		for (pugi::xml_node node = doc.child("device"); node; node = node.next_sibling("device"))
+			expected.devices.insert(node.text().get());
+
+	return expected;
+}
+
+static void checkLookups(const Expected& expected)
+{
+	MameNames* names = MameNames::getInstance();
+
+	for (auto& name : expected.names)
+		TEST_CHECK(names->getRealName(name.first) == name.second);
+
+	for (auto& bios : expected.bioses)
+		TEST_CHECK(names->isBios(bios));
+
+	for (auto& device : expected.devices)
+		TEST_CHECK(names->isDevice(device));
+
+	// names of one list are not found in the others
+	for (auto& name : expected.names)
+	{
+		TEST_CHECK(names->isBios(name.first) == (expected.bioses.find(name.first) != expected.bioses.cend()));
+		TEST_CHECK(names->isDevice(name.first) == (expected.devices.find(name.first) != expected.devices.cend()));
+	}
+
+	for (auto unknown : { "notamamegame", "zzzzzzzz", "0" })
+	{
+		TEST_CHECK(names->getRealName(unknown) == unknown);
+		TEST_CHECK(!names->isBios(unknown));
+		TEST_CHECK(!names->isDevice(unknown));
+	}
+}
+
+int main(int /*argc*/, char** /*argv*/)
+{
+	std::string home = Utils::FileSystem::getCWDPath() + "/MameNamesTest";
+	Utils::FileSystem::createDirectory(home + "/.emulationstation");
+	Utils::FileSystem::setHomePath(home);
+	Utils::FileSystem::setExePath(ES_SOURCE_DIR);
+
+	std::string database = home + "/.emulationstation/mamenames.db";
+	Utils::FileSystem::removeFile(database);
+
+	Expected expected = parseXml();
+	TEST_CHECK(!expected.names.empty());
+	TEST_CHECK(!expected.bioses.empty());
+	TEST_CHECK(!expected.devices.empty());
+
+	// built from the XML files
+	MameNames::init();
+	checkLookups(expected);
+	MameNames::deinit();
+
+	TEST_CHECK(Utils::FileSystem::exists(database));
+
+	// mapped from the database written above
+	MameNames::init();
+	checkLookups(expected);
+	MameNames::deinit();
+
+	// a truncated database is rebuilt
+	std::string content;
+	{
+		std::ifstream in(database, std::ios::binary);
+		content.assign((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+	}
+
+	TEST_CHECK(!content.empty());
+	{
+		std::ofstream out(database, std::ios::binary | std::ios::trunc);
+		out.write(content.data(), content.size() / 2);
+	}
+
+	MameNames::init();
+	checkLookups(expected);
+	MameNames::deinit();
+
+	TEST_CHECK(Utils::FileSystem::getFileSize(database) == content.size());
+
+	return TEST_RESULT();
+}
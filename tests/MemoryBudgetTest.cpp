@@ -0,0 +1,187 @@
+#include "MemoryBudget.h"
+#include "Settings.h"
+#include "Test.h"
+#include <map>
+#include <memory>
+#include <random>
+
+// Simulated caches filled while "browsing" : once the budget has been checked, the memory in use must be under the
+// configured budget, evicted in priority order, and only what can't be evicted may stay over it.
+
+#define KB 1024
+#define MB (1024 * 1024)
+
+static unsigned int sTicks = 0;
+
+struct SimulatedCache
+{
+	std::map<unsigned int, size_t> items; // size by last use, oldest first
+
+	void load(size_t size) { items[++sTicks] = size; }
+
+	size_t getSize() const
+	{
+		size_t total = 0;
+		for (auto& item : items)
+			total += item.second;
+
+		return total;
+	}
+
+	unsigned int getLastUse() const { return items.empty() ? sTicks : items.cbegin()->first; }
+
+	size_t evict(size_t bytes)
+	{
+		size_t freed = 0;
+		while (freed < bytes && !items.empty())
+		{
+			freed += items.cbegin()->second;
+			items.erase(items.cbegin());
+		}
+
+		return freed;
+	}
+};
+
+static int addCache(const std::string& name, int priority, SimulatedCache& cache, bool evictable = true)
+{
+	MemoryBudget::Consumer consumer;
+	consumer.name = name;
+	consumer.priority = priority;
+	consumer.getSize = [&cache]() { return cache.getSize(); };
+	consumer.getLastUse = [&cache]() { return cache.getLastUse(); };
+
+	if (evictable)
+		consumer.evict = [&cache](size_t bytes) { return cache.evict(bytes); };
+
+	return MemoryBudget::add(consumer);
+}
+
+// the budget is checked twice per second
+static void checkBudget()
+{
+	MemoryBudget::update(500);
+}
+
+int main(int /*argc*/, char** /*argv*/)
+{
+	const int budgetMb = 8;
+	const size_t budget = (size_t)budgetMb * MB;
+
+	Settings::getInstance()->setInt("MemoryBudget", budgetMb);
+
+	SimulatedCache views;
+	SimulatedCache textures;
+	SimulatedCache fonts;
+
+	int viewsId = addCache("Views", 0, views);
+	int texturesId = addCache("Textures", 1, textures);
+	int fontsId = addCache("Fonts", 2, fonts, false);
+
+	fonts.load(1 * MB);
+
+	// Browsing : each step loads a few textures and sometimes a view
+	std::mt19937 random(0x45533530);
+
+	for (int step = 0; step < 2000; step++)
+	{
+		for (int i = 0; i < 4; i++)
+			textures.load((64 + random() % 960) * KB);
+
+		if (step % 10 == 0)
+			views.load((256 + random() % 768) * KB);
+
+		checkBudget();
+		TEST_CHECK(MemoryBudget::getTotalSize() <= budget);
+	}
+
+	// The lowest priority is evicted first : the views go before the textures
+	views.items.clear();
+	textures.items.clear();
+
+	textures.load(3 * MB);
+	views.load(3 * MB);
+	textures.load(2 * MB);
+
+	checkBudget();
+	TEST_CHECK(MemoryBudget::getTotalSize() <= budget);
+	TEST_CHECK(views.items.empty());
+	TEST_CHECK(textures.getSize() == 5 * MB);
+
+	// Within a priority, what was used last is kept
+	textures.load(3 * MB);
+
+	checkBudget();
+	TEST_CHECK(MemoryBudget::getTotalSize() <= budget);
+	TEST_CHECK(textures.getSize() == 5 * MB);
+	TEST_CHECK(textures.items.cbegin()->second == 2 * MB);
+
+	// Nothing more to evict : everything that can go is gone, and the check returns
+	fonts.load(10 * MB);
+
+	checkBudget();
+	TEST_CHECK(MemoryBudget::getTotalSize() == fonts.getSize());
+
+	fonts.items.clear();
+	fonts.load(1 * MB);
+
+	// Without a budget nothing is evicted
+	Settings::getInstance()->setInt("MemoryBudget", 0);
+
+	for (int i = 0; i < 16; i++)
+		textures.load(1 * MB);
+
+	checkBudget();
+	TEST_CHECK(textures.getSize() == 16 * MB);
+
+	// Only the checks evict : a frame that doesn't reach the check delay leaves the caches alone
+	Settings::getInstance()->setInt("MemoryBudget", budgetMb);
+
+	MemoryBudget::update(100);
+	TEST_CHECK(textures.getSize() == 16 * MB);
+
+	MemoryBudget::update(400);
+	TEST_CHECK(MemoryBudget::getTotalSize() <= budget);
+
+	// A cache can destroy others while it evicts, as views destroying their textures do : they are not called anymore
+	SimulatedCache owner;
+	std::unique_ptr<SimulatedCache> owned(new SimulatedCache());
+	int ownedId = addCache("Owned", 1, *owned);
+
+	MemoryBudget::Consumer ownerConsumer;
+	ownerConsumer.name = "Owner";
+	ownerConsumer.priority = 0;
+	ownerConsumer.getSize = [&owner]() { return owner.getSize(); };
+	ownerConsumer.evict = [&](size_t bytes)
+	{
+		if (ownedId != 0)
+		{
+			MemoryBudget::remove(ownedId);
+			owned.reset();
+			ownedId = 0;
+		}
+
+		return owner.evict(bytes);
+	};
+
+	int ownerId = MemoryBudget::add(ownerConsumer);
+
+	owned->load(4 * MB);
+	owner.load(4 * MB);
+
+	checkBudget();
+	TEST_CHECK(ownedId == 0);
+	TEST_CHECK(owner.items.empty());
+
+	MemoryBudget::remove(ownerId);
+	if (ownedId != 0)
+		MemoryBudget::remove(ownedId);
+
+	MemoryBudget::remove(viewsId);
+	MemoryBudget::remove(texturesId);
+	MemoryBudget::remove(fontsId);
+
+	TEST_CHECK(MemoryBudget::getTotalSize() == 0);
+
+	return TEST_RESULT();
+}
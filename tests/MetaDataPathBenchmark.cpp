@@ -0,0 +1,62 @@
+#include "utils/FileSystemUtil.h"
+#include "Benchmark.h"
+#include "MetaData.h"
+#include <pugixml/src/pugixml.hpp>
+#include <stdio.h>
+#include <vector>
+
+// Media paths read by a grid of 10k games : get() returns the path resolved when the gamelist was loaded,
+// it used to resolve the relative path stored in the gamelist on every call.
+
+#define GAME_COUNT 10000
+#define PASSES     10
+
+static const char* sMediaKeys[] = { "image", "thumbnail", "marquee" };
+
+int main(int /*argc*/, char** /*argv*/)
+{
+	const std::string startPath = "/home/pi/RetroPie/roms/snes";
+
+	pugi::xml_document doc;
+	std::vector<MetaDataList> resolved;
+	std::vector<MetaDataList> relative;
+
+	for (int i = 0; i < GAME_COUNT; i++)
+	{
+		char name[16];
+		snprintf(name, sizeof(name), "game%05d", i);
+
+		// some media are in the home folder, which goes through getCanonicalPath
+		std::string prefix = (i % 10 == 0) ? "~/.emulationstation/downloaded_media/snes/" : "./media/";
+
+		pugi::xml_node relativeNode = doc.append_child("game");
+		pugi::xml_node resolvedNode = doc.append_child("game");
+
+		for (auto key : sMediaKeys)
+		{
+			std::string path = prefix + key + "s/" + name + ".png";
+
+			relativeNode.append_child(key).text().set(path.c_str());
+			resolvedNode.append_child(key).text().set(Utils::FileSystem::resolveRelativePath(path, startPath, true).c_str());
+		}
+
+		relative.push_back(MetaDataList::createFromXML(GAME_METADATA, relativeNode, nullptr));
+		resolved.push_back(MetaDataList::createFromXML(GAME_METADATA, resolvedNode, nullptr));
+	}
+
+	size_t iterations = (size_t)GAME_COUNT * PASSES;
+
+	benchmark("get() of resolved media paths", iterations, [&](size_t i)
+	{
+		for (auto key : sMediaKeys)
+			doNotOptimize(resolved[i % GAME_COUNT].get(key));
+	});
+
+	benchmark("get() + resolveRelativePath (previous)", iterations, [&](size_t i)
+	{
+		for (auto key : sMediaKeys)
+			doNotOptimize(Utils::FileSystem::resolveRelativePath(relative[i % GAME_COUNT].get(key), startPath, true));
+	});
+
+	return 0;
+}
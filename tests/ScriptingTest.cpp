@@ -0,0 +1,199 @@
+#include "utils/FileSystemUtil.h"
+#include "Scripting.h"
+#include "Test.h"
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+#if !WIN32
+#include <sys/stat.h>
+#endif
+
+// Shell scripts that write to a journal when they start and end, hooked on the events : blocking events run their
+// scripts in order before returning, the others run in the background, are coalesced, dropped by a game launch and
+// waited for by an exit. A script added to a directory is seen on the next check, even within the same second.
+
+static std::string sHome;
+static std::string sJournal;
+
+typedef std::chrono::steady_clock Clock;
+
+static void writeScript(const std::string& eventName, const std::string& name, double seconds)
+{
+	std::string directory = sHome + "/.emulationstation/scripts/" + eventName;
+	Utils::FileSystem::createDirectory(directory);
+
+	std::string path = directory + "/" + name;
+	{
+		std::ofstream script(path);
+		script << "#!/bin/sh\n";
+		script << "echo \"" << eventName << " " << name << " start $1\" >> \"" << sJournal << "\"\n";
+		script << "sleep " << seconds << "\n";
+		script << "echo \"" << eventName << " " << name << " end $1\" >> \"" << sJournal << "\"\n";
+	}
+
+	chmod(path.c_str(), 0755);
+}
+
+static std::vector<std::string> readJournal()
+{
+	std::vector<std::string> lines;
+
+	std::ifstream journal(sJournal);
+	std::string line;
+	while (std::getline(journal, line))
+		lines.push_back(line);
+
+	return lines;
+}
+
+static bool hasLine(const std::string& line)
+{
+	for (auto& journalLine : readJournal())
+		if (journalLine == line)
+			return true;
+
+	return false;
+}
+
+static int lineIndex(const std::string& line)
+{
+	std::vector<std::string> lines = readJournal();
+	for (size_t i = 0; i < lines.size(); i++)
+		if (lines[i] == line)
+			return (int)i;
+
+	return -1;
+}
+
+static bool waitForLine(const std::string& line, int timeout)
+{
+	auto start = Clock::now();
+
+	while (!hasLine(line))
+	{
+		if (Clock::now() - start > std::chrono::milliseconds(timeout))
+			return false;
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+
+	return true;
+}
+
+static double elapsedSince(Clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static void clearJournal()
+{
+	std::ofstream journal(sJournal, std::ios::trunc);
+}
+
+int main(int /*argc*/, char** /*argv*/)
+{
+#if WIN32
+	std::cout << "shell scripts, skipped on Windows\n";
+	return 0;
+#else
+	sHome = Utils::FileSystem::getCWDPath() + "/ScriptingTest";
+	sJournal = sHome + "/journal.txt";
+
+	Utils::FileSystem::setHomePath(sHome);
+	Utils::FileSystem::setExePath(sHome + "/exe");
+	Utils::FileSystem::createDirectory(sHome + "/.emulationstation/scripts");
+
+	for (auto eventName : { "game-start", "game-selected", "theme-changed", "quit" })
+		for (auto script : Utils::FileSystem::getDirContent(sHome + "/.emulationstation/scripts/" + eventName))
+			Utils::FileSystem::removeFile(script);
+
+	writeScript("game-start", "01.sh", 0.2);
+	writeScript("game-start", "02.sh", 0.2);
+	writeScript("game-selected", "01.sh", 0.5);
+	writeScript("theme-changed", "01.sh", 0.5);
+	writeScript("quit", "01.sh", 0);
+
+	// Blocking : both scripts ran, in order, before fireEvent returned
+	clearJournal();
+
+	auto start = Clock::now();
+	Scripting::fireEvent("game-start", "game1");
+	TEST_CHECK(elapsedSince(start) >= 400);
+
+	std::vector<std::string> lines = readJournal();
+	TEST_CHECK(lines == std::vector<std::string>({ "game-start 01.sh start game1", "game-start 01.sh end game1", "game-start 02.sh start game1", "game-start 02.sh end game1" }));
+
+	// Background : fireEvent returns at once, the script runs afterwards
+	clearJournal();
+
+	start = Clock::now();
+	Scripting::fireEvent("game-selected", "a");
+	TEST_CHECK(elapsedSince(start) < 200);
+	TEST_CHECK(!hasLine("game-selected 01.sh end a"));
+	TEST_CHECK(waitForLine("game-selected 01.sh end a", 5000));
+
+	// Coalesced : while "a" runs, "b" "c" & "d" are fired, only the last one runs after it
+	clearJournal();
+
+	Scripting::fireEvent("game-selected", "a");
+	TEST_CHECK(waitForLine("game-selected 01.sh start a", 5000));
+
+	for (auto arg : { "b", "c", "d" })
+		Scripting::fireEvent("game-selected", arg);
+
+	TEST_CHECK(waitForLine("game-selected 01.sh end d", 5000));
+	TEST_CHECK(!hasLine("game-selected 01.sh start b"));
+	TEST_CHECK(!hasLine("game-selected 01.sh start c"));
+
+	// A game launch doesn't wait for the running selection and drops the queued one
+	clearJournal();
+
+	Scripting::fireEvent("game-selected", "x");
+	TEST_CHECK(waitForLine("game-selected 01.sh start x", 5000));
+	Scripting::fireEvent("game-selected", "y");
+
+	start = Clock::now();
+	Scripting::fireEvent("game-start", "game2");
+	TEST_CHECK(elapsedSince(start) < 900);
+
+	TEST_CHECK(waitForLine("game-selected 01.sh end x", 5000));
+	std::this_thread::sleep_for(std::chrono::milliseconds(700));
+	TEST_CHECK(!hasLine("game-selected 01.sh start y"));
+
+	// An exit waits for the background events before running its scripts
+	clearJournal();
+
+	Scripting::fireEvent("theme-changed", "theme");
+	Scripting::fireEvent("quit");
+
+	TEST_CHECK(lineIndex("theme-changed 01.sh end theme") >= 0);
+	TEST_CHECK(lineIndex("quit 01.sh start ") > lineIndex("theme-changed 01.sh end theme"));
+
+	// Scripts added to the directory are run once it is checked again, SCRIPTING_CHECK_DELAY later. The second one is added
+	// in the same second as the listing, so the date of the directory doesn't change
+	clearJournal();
+	std::this_thread::sleep_for(std::chrono::milliseconds(2100));
+
+	time_t second = time(nullptr);
+	while (time(nullptr) == second)
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+	writeScript("game-start", "00.sh", 0);
+	Scripting::fireEvent("game-start", "game3");
+	writeScript("game-start", "03.sh", 0);
+
+	TEST_CHECK(hasLine("game-start 00.sh end game3"));
+	TEST_CHECK(!hasLine("game-start 03.sh start game3"));
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(2100));
+	Scripting::fireEvent("game-start", "game4");
+
+	TEST_CHECK(hasLine("game-start 03.sh end game4"));
+	TEST_CHECK(lineIndex("game-start 03.sh start game4") > lineIndex("game-start 02.sh end game4"));
+
+	return TEST_RESULT();
+#endif
+}
@@ -0,0 +1,46 @@
+#include "utils/FileSystemUtil.h"
+#include "Benchmark.h"
+#include "Settings.h"
+
+// Settings read every frame (Window) or for every item of a gamelist (FileData) : a lookup by name in the
+// maps of settings, against the slot resolved once that this code now reads.
+
+#define ITERATIONS 10000000
+
+int main(int /*argc*/, char** /*argv*/)
+{
+	// defaults only, not the settings of the user running it
+	std::string home = Utils::FileSystem::getCWDPath() + "/SettingsBenchmark";
+	Utils::FileSystem::createDirectory(home + "/.emulationstation");
+	Utils::FileSystem::setHomePath(home);
+
+	Settings* settings = Settings::getInstance();
+	std::cout << settings->getStringMap().size() << " string settings\n";
+
+	const bool* drawFramerate = settings->getBoolSlot("DrawFramerate");
+	const bool* showFilenames = settings->getBoolSlot("ShowFilenames");
+	const int* screenSaverTime = settings->getIntSlot("ScreenSaverTime");
+	const std::string* language = settings->getStringSlot("Language");
+
+	benchmark("getBool(\"DrawFramerate\")", ITERATIONS, [&](size_t) { doNotOptimize(settings->getBool("DrawFramerate")); });
+	benchmark("*getBoolSlot(\"DrawFramerate\")", ITERATIONS, [&](size_t) { doNotOptimize(*drawFramerate); });
+
+	benchmark("getBool(\"ShowFilenames\")", ITERATIONS, [&](size_t) { doNotOptimize(settings->getBool("ShowFilenames")); });
+	benchmark("*getBoolSlot(\"ShowFilenames\")", ITERATIONS, [&](size_t) { doNotOptimize(*showFilenames); });
+
+	benchmark("getInt(\"ScreenSaverTime\")", ITERATIONS, [&](size_t) { doNotOptimize(settings->getInt("ScreenSaverTime")); });
+	benchmark("*getIntSlot(\"ScreenSaverTime\")", ITERATIONS, [&](size_t) { doNotOptimize(*screenSaverTime); });
+
+	benchmark("getString(\"Language\")", ITERATIONS, [&](size_t) { doNotOptimize(settings->getString("Language").size()); });
+	benchmark("*getStringSlot(\"Language\")", ITERATIONS, [&](size_t) { doNotOptimize(language->size()); });
+
+	// the slot sees the changes made through the setters
+	settings->setBool("DrawFramerate", !*drawFramerate);
+	if (*drawFramerate != settings->getBool("DrawFramerate"))
+	{
+		std::cerr << "the slot doesn't follow setBool\n";
+		return 1;
+	}
+
+	return 0;
+}
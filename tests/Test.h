@@ -0,0 +1,22 @@
+#pragma once
+#ifndef ES_TESTS_TEST_H
+#define ES_TESTS_TEST_H
+
+#include <iostream>
+
+// A failed check is reported and the test goes on, TEST_RESULT() is the exit code of the test
+static int sTestFailures = 0;
+
+#define TEST_CHECK(condition) \
+	do \
+	{ \
+		if (!(condition)) \
+		{ \
+			std::cerr << __FILE__ << ":" << __LINE__ << " : check failed : " << #condition << "\n"; \
+			sTestFailures++; \
+		} \
+	} while (0)
+
+#define TEST_RESULT() (sTestFailures == 0 ? 0 : 1)
+
+#endif // ES_TESTS_TEST_H
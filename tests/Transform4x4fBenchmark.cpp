@@ -0,0 +1,61 @@
+#include "math/Transform4x4f.h"
+#include "Benchmark.h"
+#include <vector>
+
+// Transform4x4f products and vector transforms, as done for each component of the tree on every frame,
+// compared with the scalar code. Build for the target (-DCMAKE_BUILD_TYPE=Release) : the SIMD path is chosen at compile time.
+
+#define ITERATIONS 10000000
+
+static Transform4x4f multiplyScalar(const Transform4x4f& a, const Transform4x4f& b)
+{
+	const float* tm = (const float*)&a;
+	const float* om = (const float*)&b;
+
+	return
+	{
+		{ tm[0] * om[ 0] + tm[4] * om[ 1] + tm[8] * om[ 2], tm[1] * om[ 0] + tm[5] * om[ 1] + tm[9] * om[ 2], tm[2] * om[ 0] + tm[6] * om[ 1] + tm[10] * om[ 2], 0 },
+		{ tm[0] * om[ 4] + tm[4] * om[ 5] + tm[8] * om[ 6], tm[1] * om[ 4] + tm[5] * om[ 5] + tm[9] * om[ 6], tm[2] * om[ 4] + tm[6] * om[ 5] + tm[10] * om[ 6], 0 },
+		{ tm[0] * om[ 8] + tm[4] * om[ 9] + tm[8] * om[10], tm[1] * om[ 8] + tm[5] * om[ 9] + tm[9] * om[10], tm[2] * om[ 8] + tm[6] * om[ 9] + tm[10] * om[10], 0 },
+		{ tm[0] * om[12] + tm[4] * om[13] + tm[8] * om[14] + tm[12], tm[1] * om[12] + tm[5] * om[13] + tm[9] * om[14] + tm[13], tm[2] * om[12] + tm[6] * om[13] + tm[10] * om[14] + tm[14], 1 }
+	};
+}
+
+static Vector3f transformScalar(const Transform4x4f& a, const Vector3f& v)
+{
+	const float* tm = (const float*)&a;
+
+	return
+	{
+		tm[0] * v.x() + tm[4] * v.y() + tm[ 8] * v.z() + tm[12],
+		tm[1] * v.x() + tm[5] * v.y() + tm[ 9] * v.z() + tm[13],
+		tm[2] * v.x() + tm[6] * v.y() + tm[10] * v.z() + tm[14]
+	};
+}
+
+int main(int /*argc*/, char** /*argv*/)
+{
+	// a few different transforms so the products can't be folded at compile time
+	std::vector<Transform4x4f> transforms;
+	for (int i = 0; i < 64; i++)
+	{
+		Transform4x4f transform = Transform4x4f::Identity();
+		transform.translate(Vector3f((float)i * 10.0f, (float)i * 5.0f, 0));
+		transform.scale(Vector3f(1.0f + (float)i / 64.0f, 1.0f, 1.0f));
+		transforms.push_back(transform);
+	}
+
+	Transform4x4f product = Transform4x4f::Identity();
+
+	benchmark("Transform4x4f * Transform4x4f", ITERATIONS, [&](size_t i) { product = transforms[i & 63] * transforms[(i + 1) & 63]; doNotOptimize(product); });
+	benchmark("Transform4x4f * Transform4x4f (scalar)", ITERATIONS, [&](size_t i) { product = multiplyScalar(transforms[i & 63], transforms[(i + 1) & 63]); doNotOptimize(product); });
+
+	Vector3f vector(0, 0, 0);
+
+	benchmark("Transform4x4f * Vector3f", ITERATIONS, [&](size_t i) { vector = transforms[i & 63] * Vector3f((float)(i & 255), 1.0f, 0); doNotOptimize(vector); });
+	benchmark("Transform4x4f * Vector3f (scalar)", ITERATIONS, [&](size_t i) { vector = transformScalar(transforms[i & 63], Vector3f((float)(i & 255), 1.0f, 0)); doNotOptimize(vector); });
+
+	benchmark("Transform4x4f::translate", ITERATIONS, [&](size_t i) { product = transforms[i & 63]; product.translate(Vector3f((float)(i & 255), 1.0f, 0)); doNotOptimize(product); });
+
+	return 0;
+}
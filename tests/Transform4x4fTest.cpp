@@ -0,0 +1,128 @@
+#include "math/Transform4x4f.h"
+#include "Test.h"
+#include <cmath>
+#include <random>
+#include <string.h>
+
+// The SSE / NEON paths must give the same bits as the scalar code they replace : positions are rounded
+// to pixels after the transforms, a different rounding moves things by one pixel.
+
+static Transform4x4f multiplyScalar(const Transform4x4f& a, const Transform4x4f& b)
+{
+	const float* tm = (const float*)&a;
+	const float* om = (const float*)&b;
+
+	return
+	{
+		{
+			tm[ 0] * om[ 0] + tm[ 4] * om[ 1] + tm[ 8] * om[ 2],
+			tm[ 1] * om[ 0] + tm[ 5] * om[ 1] + tm[ 9] * om[ 2],
+			tm[ 2] * om[ 0] + tm[ 6] * om[ 1] + tm[10] * om[ 2],
+			0
+		},
+		{
+			tm[ 0] * om[ 4] + tm[ 4] * om[ 5] + tm[ 8] * om[ 6],
+			tm[ 1] * om[ 4] + tm[ 5] * om[ 5] + tm[ 9] * om[ 6],
+			tm[ 2] * om[ 4] + tm[ 6] * om[ 5] + tm[10] * om[ 6],
+			0
+		},
+		{
+			tm[ 0] * om[ 8] + tm[ 4] * om[ 9] + tm[ 8] * om[10],
+			tm[ 1] * om[ 8] + tm[ 5] * om[ 9] + tm[ 9] * om[10],
+			tm[ 2] * om[ 8] + tm[ 6] * om[ 9] + tm[10] * om[10],
+			0
+		},
+		{
+			tm[ 0] * om[12] + tm[ 4] * om[13] + tm[ 8] * om[14] + tm[12],
+			tm[ 1] * om[12] + tm[ 5] * om[13] + tm[ 9] * om[14] + tm[13],
+			tm[ 2] * om[12] + tm[ 6] * om[13] + tm[10] * om[14] + tm[14],
+			1
+		}
+	};
+}
+
+static Vector3f transformScalar(const Transform4x4f& a, const Vector3f& v)
+{
+	const float* tm = (const float*)&a;
+	const float* ov = (const float*)&v;
+
+	return
+	{
+		tm[ 0] * ov[0] + tm[ 4] * ov[1] + tm[ 8] * ov[2] + tm[12],
+		tm[ 1] * ov[0] + tm[ 5] * ov[1] + tm[ 9] * ov[2] + tm[13],
+		tm[ 2] * ov[0] + tm[ 6] * ov[1] + tm[10] * ov[2] + tm[14]
+	};
+}
+
+static Transform4x4f translateScalar(Transform4x4f a, const Vector3f& v)
+{
+	float*       tm = (float*)&a;
+	const float* tv = (const float*)&v;
+
+	tm[12] += tm[ 0] * tv[0] + tm[ 4] * tv[1] + tm[ 8] * tv[2];
+	tm[13] += tm[ 1] * tv[0] + tm[ 5] * tv[1] + tm[ 9] * tv[2];
+	tm[14] += tm[ 2] * tv[0] + tm[ 6] * tv[1] + tm[10] * tv[2];
+
+	return a;
+}
+
+// Mostly UI-like values (scales around 1, translations in pixels), with some large, tiny and negative ones
+static float randomFloat(std::mt19937& random)
+{
+	switch (random() % 4)
+	{
+	case 0:  return std::uniform_real_distribution<float>(-2.0f, 2.0f)(random);
+	case 1:  return std::uniform_real_distribution<float>(-4096.0f, 4096.0f)(random);
+	case 2:  return std::ldexp(std::uniform_real_distribution<float>(-1.0f, 1.0f)(random), (int)(random() % 80) - 40);
+	default: return (float)((int)(random() % 3) - 1);
+	}
+}
+
+static Transform4x4f randomTransform(std::mt19937& random)
+{
+	Transform4x4f transform;
+	float* tm = (float*)&transform;
+
+	for (int i = 0; i < 16; i++)
+		tm[i] = randomFloat(random);
+
+	tm[ 3] = 0;
+	tm[ 7] = 0;
+	tm[11] = 0;
+	tm[15] = 1;
+
+	return transform;
+}
+
+int main(int /*argc*/, char** /*argv*/)
+{
+	std::mt19937 random(0x45533335);
+
+	for (int i = 0; i < 1000000; i++)
+	{
+		Transform4x4f a = randomTransform(random);
+		Transform4x4f b = randomTransform(random);
+		Vector3f      v(randomFloat(random), randomFloat(random), randomFloat(random));
+
+		Transform4x4f product  = a * b;
+		Transform4x4f expected = multiplyScalar(a, b);
+		TEST_CHECK(memcmp(&product, &expected, sizeof(Transform4x4f)) == 0);
+
+		Vector3f transformed         = a * v;
+		Vector3f expectedTransformed = transformScalar(a, v);
+		TEST_CHECK(memcmp(&transformed, &expectedTransformed, sizeof(Vector3f)) == 0);
+
+		Transform4x4f translated         = a;
+		Transform4x4f expectedTranslated = translateScalar(a, v);
+		translated.translate(v);
+		TEST_CHECK(memcmp(&translated, &expectedTranslated, sizeof(Transform4x4f)) == 0);
+
+		if (sTestFailures > 0)
+		{
+			std::cerr << "first difference at iteration " << i << "\n";
+			break;
+		}
+	}
+
+	return TEST_RESULT();
+}